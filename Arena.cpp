@@ -0,0 +1,213 @@
+/**
+ * @file    Arena.cpp
+ *
+ * @brief   Implementation of class Arena
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include <stdio.h>
+#include <new>
+#include <algorithm>
+#include "Arena.h"
+#include "BufferPool.h"
+#include "ByteArray.h"      //_BYTEARRAY_HEAP_
+
+
+/**
+ * @brief   class constructor
+ *
+ * @param   buffer      caller-provided first chunk, optional, see FixedArena
+ * @param   buffersize  size of buffer
+ * @param   chunksize   bytes per added chunk incl. its header, at most a pool block
+ */
+Arena::Arena( uint8_t* buffer, uint16_t buffersize, uint16_t chunksize )
+     : _Buffer      ( buffer )
+     , _BufferSize  ( buffer ? buffersize : 0 )
+     , _ChunkSize   ( chunksize )
+     , _Chunks      ( nullptr )
+     , _Top         ( buffer )
+     , _TopSize     ( buffer ? buffersize : 0 )
+     , _TopUsed     ( 0 )
+     , _Last        ( nullptr )
+     , _Used        ( 0 )
+     , _Stats       () {
+}
+
+
+/**
+ * @brief   class destructor, releases all chunks
+ */
+Arena::~Arena( void ) {
+    Reset();
+}
+
+
+/**
+ * @brief   allocate bytes
+ *
+ * @param   size    requested size
+ *
+ * @return  pointer to Align aligned bytes, nullptr if out of memory
+ */
+uint8_t*
+Arena::Allocate( uint16_t size ) {
+    uint32_t aligned = ( (uint32_t)size + Align - 1 ) & ~(uint32_t)( Align - 1 );
+
+    if ( ( (uint32_t)_TopUsed + aligned > _TopSize ) && !grow( (uint16_t)aligned ) ) {
+        _Stats.Failures++;
+        return nullptr;
+    }
+
+    uint8_t* block = _Top + _TopUsed;
+    _TopUsed += (uint16_t)aligned;
+    _Last     = block;
+    _Used    += aligned;
+
+    _Stats.Allocations++;
+    if ( _Used > _Stats.HighWater ) {
+        _Stats.HighWater = _Used;
+    }
+    return block;
+}
+
+
+/**
+ * @brief   grow an allocation in place
+ *
+ * @param   block   pointer returned by Allocate()
+ * @param   newsize required size of block
+ *
+ * @return  true if block is the last allocation and its chunk has room
+ */
+bool
+Arena::Extend( uint8_t* block, uint16_t newsize ) {
+    if ( ( nullptr == block ) || ( block != _Last ) ) {
+        return false;
+    }
+
+    uint32_t aligned = ( (uint32_t)newsize + Align - 1 ) & ~(uint32_t)( Align - 1 );
+    uint32_t offset  = (uint32_t)( block - _Top );
+    if ( offset + aligned > _TopSize ) {
+        return false;
+    }
+    if ( offset + aligned > _TopUsed ) {
+        _Used   += offset + aligned - _TopUsed;
+        _TopUsed = (uint16_t)( offset + aligned );
+    }
+
+    _Stats.Extended++;
+    if ( _Used > _Stats.HighWater ) {
+        _Stats.HighWater = _Used;
+    }
+    return true;
+}
+
+
+/**
+ * @return  largest allocation an added chunk can take, a pool block
+ *          without heap
+ */
+uint16_t
+Arena::GetMaxAllocation( void ) {
+#if 0 == _BYTEARRAY_HEAP_
+    return (uint16_t)( ( BufferPool::Max_Block_Size - sizeof( Chunk ) ) & ~(uint32_t)( Align - 1 ) );
+#else
+    return 0xFFFF - sizeof( Chunk );
+#endif
+}
+
+
+/**
+ * @brief   release all allocations in one shot, added chunks are returned
+ *          to BufferPool or heap, the first chunk is kept
+ */
+void
+Arena::Reset( void ) {
+    while ( _Chunks ) {
+        Chunk* chunk = _Chunks;
+        _Chunks = chunk->Next;
+        if ( !BufferPool::Free( (uint8_t*)chunk ) ) {
+            delete[] (uint8_t*)chunk;
+        }
+    }
+    _Top     = _Buffer;
+    _TopSize = _BufferSize;
+    _TopUsed = 0;
+    _Last    = nullptr;
+    _Used    = 0;
+    _Stats.Resets++;
+}
+
+
+/**
+ * @brief   add a chunk of at least size bytes and make it current,
+ *          the rest of the current chunk is left unused
+ *
+ * @param   size    bytes required
+ *
+ * @return  true/false
+ */
+bool
+Arena::grow( uint16_t size ) {
+    //round up to the chunk size, but not beyond a pool block
+    uint32_t total = sizeof( Chunk ) + (uint32_t)size;
+    uint32_t round = std::min( (uint32_t)_ChunkSize, (uint32_t)BufferPool::Max_Block_Size );
+    if ( total < round ) {
+        total = round;
+    }
+    if ( total > 0xFFFF ) {
+        return false;
+    }
+#if 0 == _BYTEARRAY_HEAP_
+    //header and bytes must fit a pool block
+    if ( total > BufferPool::Max_Block_Size ) {
+        return false;
+    }
+#endif
+
+    //pool blocks first, use the whole block
+    uint16_t blocksize = 0;
+    uint8_t* pnew = BufferPool::Allocate( total, blocksize );
+    if ( pnew ) {
+        total = blocksize;
+    }
+#if 0 != _BYTEARRAY_HEAP_
+    else {
+        pnew = new (std::nothrow) uint8_t[total];
+    }
+#endif
+    if ( nullptr == pnew ) {
+        return false;
+    }
+
+    Chunk* chunk = (Chunk*)pnew;
+    chunk->Next  = _Chunks;
+    chunk->Size  = (uint16_t)( total - sizeof( Chunk ) );
+    _Chunks      = chunk;
+
+    _Top     = (uint8_t*)( chunk + 1 );
+    _TopSize = chunk->Size;
+    _TopUsed = 0;
+    _Last    = nullptr;
+    _Stats.Chunks++;
+    return true;
+}
+
+
+/**
+ * @brief   prints arena statistics
+ */
+void
+Arena::print( void ) const {
+    printf( "Arena: %lu bytes used, high water %lu, allocations %lu, extended %lu, chunks %lu, failures %lu, resets %lu\r\n",
+        (unsigned long)_Used, (unsigned long)_Stats.HighWater,
+        (unsigned long)_Stats.Allocations, (unsigned long)_Stats.Extended,
+        (unsigned long)_Stats.Chunks, (unsigned long)_Stats.Failures,
+        (unsigned long)_Stats.Resets );
+}
@@ -0,0 +1,192 @@
+/**
+ * @file    Arena.h
+ *
+ * @brief   Declaration of classes Arena and FixedArena
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _Arena_H_
+#define _Arena_H_
+
+#include <stdint.h>
+
+
+/**
+ * @brief   The Arena class is a bump allocator for data living as long as one
+ *          event, e.g. the decoded Dictionary of a received message.
+ *          Allocate() takes the next bytes of the current chunk, a full chunk is
+ *          followed by a new one from BufferPool (then heap), nothing is freed
+ *          one by one: Reset() releases all chunks in one shot.
+ *
+ *          The last allocation can grow in place while its chunk has room, so
+ *          a growing ByteArray on an arena is mostly not copied.
+ *
+ * @note    not thread safe, an arena belongs to one consumer
+ */
+
+class Arena {
+
+public:
+
+    enum {
+        //<! default bytes per chunk incl. its header, a BufferPool size class
+        Chunk_Size      =   256,
+        //<! alignment of allocations
+        Align           =   4
+    };
+
+    //<! arena statistics
+    struct Stats {
+        uint32_t    Allocations;    //!< successful allocations
+        uint32_t    Extended;       //!< allocations grown in place
+        uint32_t    Chunks;         //!< chunks added, growth beyond the first chunk
+        uint32_t    Failures;       //!< allocations out of memory
+        uint32_t    Resets;         //!< Reset() calls
+        uint32_t    HighWater;      //!< max bytes allocated between resets
+    };
+
+    /**
+     * @brief   class constructor
+     *
+     * @param   buffer      caller-provided first chunk, optional, see FixedArena
+     * @param   buffersize  size of buffer
+     * @param   chunksize   bytes per added chunk incl. its header, at most a pool block
+     */
+                    Arena( uint8_t* buffer = nullptr, uint16_t buffersize = 0, uint16_t chunksize = Chunk_Size );
+
+    /**
+     * @brief   class destructor, releases all chunks
+     */
+                   ~Arena( void );
+
+                    Arena( const Arena& ) = delete;
+    Arena&          operator = ( const Arena& ) = delete;
+
+    /**
+     * @brief   allocate bytes
+     *
+     * @param   size    requested size
+     *
+     * @return  pointer to Align aligned bytes, nullptr if out of memory
+     */
+    uint8_t*        Allocate( uint16_t size );
+
+    /**
+     * @brief   grow an allocation in place
+     *
+     * @param   block   pointer returned by Allocate()
+     * @param   newsize required size of block
+     *
+     * @return  true if block is the last allocation and its chunk has room
+     */
+    bool            Extend( uint8_t* block, uint16_t newsize );
+
+    /**
+     * @return  largest allocation an added chunk can take
+     */
+    static uint16_t GetMaxAllocation( void );
+
+    /**
+     * @brief   release all allocations in one shot, added chunks are returned
+     *          to BufferPool or heap, the first chunk is kept
+     */
+    void            Reset( void );
+
+    /**
+     * @return  bytes allocated since Reset()
+     */
+    uint32_t        GetUsed( void ) const { return _Used; }
+
+    /**
+     * @return  arena statistics
+     */
+    const Stats&    GetStats( void ) const { return _Stats; }
+
+    /**
+     * @brief   prints arena statistics
+     */
+    void            print( void ) const;
+
+private:
+
+    //<! header of a chunk, its bytes follow
+    struct Chunk {
+        Chunk*      Next;           //!< previous chunk, newest first
+        uint16_t    Size;           //!< bytes following the header
+    };
+
+    /**
+     * @brief   add a chunk of at least size bytes and make it current
+     *
+     * @return  true/false
+     */
+    bool            grow( uint16_t size );
+
+    //<! caller-provided first chunk
+    uint8_t*        _Buffer;
+
+    //<! size of the first chunk
+    uint16_t        _BufferSize;
+
+    //<! bytes per added chunk incl. its header
+    uint16_t        _ChunkSize;
+
+    //<! added chunks, newest first
+    Chunk*          _Chunks;
+
+    //<! bytes of the current chunk
+    uint8_t*        _Top;
+
+    //<! size of the current chunk
+    uint16_t        _TopSize;
+
+    //<! bytes taken of the current chunk
+    uint16_t        _TopUsed;
+
+    //<! last allocation, it can be extended
+    uint8_t*        _Last;
+
+    //<! bytes allocated since Reset()
+    uint32_t        _Used;
+
+    //<! arena statistics
+    Stats           _Stats;
+};
+
+
+/**
+ * @brief   The FixedArena class is an Arena with an embedded first chunk of N
+ *          bytes, an event which fits it never allocates.
+ */
+
+template < uint16_t N = 512 >
+
+class FixedArena : public Arena {
+
+    static_assert( N >= Arena::Align, "FixedArena: size too small" );
+
+public:
+
+    //<! compile-time size of the first chunk
+    static constexpr uint16_t   Capacity    =   N;
+
+        /**
+          * @brief  class constructor
+          *
+          * @param  chunksize   bytes per added chunk incl. its header
+          */
+                    FixedArena( uint16_t chunksize = Arena::Chunk_Size ) :
+                        Arena( _storage, N, chunksize ) {}
+
+private:
+    //<! embedded first chunk
+    alignas( 8 ) uint8_t    _storage[ N ];
+};
+
+#endif // _Arena_H_
@@ -0,0 +1,333 @@
+/**
+ * @file    Benchmark.cpp
+ *
+ * @brief   Implementation of class Benchmark
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include <stdio.h>
+#include <string>
+#include "Benchmark.h"
+#include "ByteArray.h"
+#include "SerialMessage.h"
+#include "HexCodec.h"
+#include "CRC16.h"
+#include "SlipEncoder.h"
+#include "FixedByteArray.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+
+//<! keeps results alive, so the compiler can not drop the measured code
+static volatile uint32_t _Sink = 0;
+
+
+/*************************************************/
+/* reference copies of the former implementations */
+
+static const uint8_t _hex_table_Legacy[16] = {
+        '0', '1', '2', '3',
+        '4', '5', '6', '7',
+        '8', '9', 'A', 'B',
+        'C', 'D', 'E', 'F'
+    };
+
+
+/**
+ * @brief   former SerialMessage::GetHexString, grows string per character
+ */
+static std::string
+GetHexString_Legacy( const ByteArrayView& rawData ) {
+
+    std::string result;
+    for( int i = 0; i < rawData.count(); i++ ) {
+
+        result += _hex_table_Legacy[ rawData.at( i ) >> 4 ];
+        result += _hex_table_Legacy[ rawData.at( i )  & 7 ];
+        result += '-';
+
+    }
+
+    uint16_t rsize = result.length();
+    if ( rsize )
+            return result.substr( 0, rsize - 1 );
+
+    return result;
+}
+
+
+/**
+ * @brief   former ByteArray::fromHex, per character branches and bounds checks,
+ *          its index bug fixed and '-' skipped, so it does the same work as HexCodec
+ */
+static ByteArray
+fromHex_Legacy( const ByteArray &hexEncoded ) {
+
+    ByteArray tfromHex( ( hexEncoded.count() >> 1 ) + ( hexEncoded.count() & 1 ) );
+
+    uint16_t j = 0;
+    while ( j < hexEncoded.count() ) {
+        uint8_t abyte = 0;
+
+        uint8_t hexb = hexEncoded.at( j++ );
+        if ( '-' == hexb ) {
+            continue;
+        }
+        if ( ( '0' <= hexb ) && ( hexb <= '9' ) ) {
+            abyte += hexb - '0';
+        } else if ( ( 'a' <= hexb ) && ( hexb <= 'f' ) ) {
+            abyte += hexb - 'a' + 10;
+        } else if ( ( 'A' <= hexb ) && ( hexb <= 'F' ) ) {
+            abyte += hexb - 'A' + 10;
+        }
+        abyte = abyte << 4;
+
+        hexb = hexEncoded.at( j++ );
+        if ( ( '0' <= hexb ) && ( hexb <= '9' ) ) {
+            abyte += hexb - '0';
+        } else if ( ( 'a' <= hexb ) && ( hexb <= 'f' ) ) {
+            abyte += hexb - 'a' + 10;
+        } else if ( ( 'A' <= hexb ) && ( hexb <= 'F' ) ) {
+            abyte += hexb - 'A' + 10;
+        }
+
+        tfromHex.append( abyte );
+    }
+    return tfromHex;
+}
+
+
+/**
+ * @brief   former SerialMessage::AppendHexString, temporaries for input and result
+ */
+static int
+AppendHexString_Legacy( SerialMessage& msg, const std::string& input ) {
+    ByteArray payload = ByteArray( input );
+    ByteArray data = fromHex_Legacy( payload );
+    if ( data.count() ) {
+        msg.append( data );
+        return data.count();
+    }
+    return 0;
+}
+
+
+/**
+ * @brief   former SlipEncoder::Encode, byte at a time append with bounds checks
+ */
+static ByteArray&
+Encode_Legacy( ByteArray& output, const ByteArrayView& input ) {
+
+    output.append( SlipEncoder::End );
+    for ( int index = 0; index < input.count(); index++ ) {
+        uint8_t byte = input[ index ];
+        switch ( byte ) {
+            case SlipEncoder::End:
+                output.append( SlipEncoder::Esc );
+                output.append( SlipEncoder::EscEnd );
+                break;
+            case SlipEncoder::Esc:
+                output.append( SlipEncoder::Esc );
+                output.append( SlipEncoder::EscEsc );
+                break;
+            default:
+                output.append( byte );
+                break;
+        }
+    }
+    output.append( SlipEncoder::End );
+    return output;
+}
+
+
+/*************************************************/
+
+
+/**
+ * @brief   returns time stamp in microseconds
+ */
+uint32_t
+Benchmark::Now_us( void ) {
+#ifdef ARDUINO
+    return micros();
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
+#endif
+}
+
+
+/**
+ * @brief   prints one result line
+ */
+static void
+printResult( const char* name, uint32_t legacy_us, uint32_t codec_us, uint32_t rounds ) {
+    printf( "%-16s legacy %7lu us, codec %7lu us, %4lu ns/call, x%lu\r\n", name,
+        (unsigned long)legacy_us, (unsigned long)codec_us,
+        (unsigned long)( ( 1000ull * codec_us ) / ( rounds ? rounds : 1 ) ),
+        (unsigned long)( codec_us ? ( legacy_us / codec_us ) : 0 ) );
+}
+
+
+/**
+ * @brief   hex encode/decode, HexCodec vs. former SerialMessage/ByteArray functions
+ *
+ * @param   size    number of payload bytes
+ * @param   rounds  number of rounds
+ */
+void
+Benchmark::HexConversion( uint16_t size, uint32_t rounds ) {
+
+    if ( 0 == size ) {
+        size = 1;
+    } else if ( size > SerialMessage::Max_Size ) {
+        size = SerialMessage::Max_Size;
+    }
+
+    SerialMessage message;
+    for ( uint16_t i = 0; i < size; i++ ) {
+        message.append( (uint8_t)( i * 37 + 11 ) );
+    }
+    std::string hexString = message.GetHexString();
+
+    printf( "Hex conversion, %u bytes, %lu rounds\r\n", size, (unsigned long)rounds );
+
+    //encode to string
+    uint32_t t0 = Now_us();
+    for ( uint32_t r = 0; r < rounds; r++ ) {
+        _Sink += GetHexString_Legacy( message ).length();
+    }
+    uint32_t t1 = Now_us();
+    for ( uint32_t r = 0; r < rounds; r++ ) {
+        _Sink += message.GetHexString().length();
+    }
+    uint32_t t2 = Now_us();
+    printResult( "GetHexString", t1 - t0, t2 - t1, rounds );
+
+    //decode into message
+    SerialMessage output;
+    t0 = Now_us();
+    for ( uint32_t r = 0; r < rounds; r++ ) {
+        output.clear();
+        _Sink += AppendHexString_Legacy( output, hexString );
+    }
+    t1 = Now_us();
+    for ( uint32_t r = 0; r < rounds; r++ ) {
+        output.clear();
+        _Sink += output.AppendHexString( hexString );
+    }
+    t2 = Now_us();
+    printResult( "AppendHexString", t1 - t0, t2 - t1, rounds );
+
+    //bulk encode into caller buffer, no separator
+    static char buffer[ 2 * SerialMessage::Max_Size ];
+    t0 = Now_us();
+    for ( uint32_t r = 0; r < rounds; r++ ) {
+        for ( uint16_t i = 0; i < size; i++ ) {
+            uint8_t abyte = message.at( i );
+            buffer[ 2 * i     ] = _hex_table_Legacy[ abyte >> 4 ];
+            buffer[ 2 * i + 1 ] = _hex_table_Legacy[ abyte & 0x0F ];
+        }
+        _Sink += buffer[ r % ( 2 * size ) ];
+    }
+    t1 = Now_us();
+    for ( uint32_t r = 0; r < rounds; r++ ) {
+        _Sink += ::HexCodec::EncodeBulk( buffer, message.data(), size );
+    }
+    t2 = Now_us();
+    printResult( "EncodeBulk", t1 - t0, t2 - t1, rounds );
+}
+
+
+/**
+ * @brief   CRC16 X.25, all available engines
+ *
+ * @param   size    number of bytes per calculation
+ * @param   rounds  number of rounds
+ */
+void
+Benchmark::CRC16Engines( uint16_t size, uint32_t rounds ) {
+
+    ByteArray data;
+    for ( uint16_t i = 0; i < size; i++ ) {
+        data.append( (uint8_t)( i * 37 + 11 ) );
+    }
+
+    printf( "CRC16 X.25, %u bytes, %lu rounds\r\n", data.count(), (unsigned long)rounds );
+
+    CRC16::Engine selected = CRC16::GetEngine();
+    for ( uint8_t e = 0; e < CRC16::Engines; e++ ) {
+        CRC16::Engine engine = (CRC16::Engine)e;
+        if ( !CRC16::SetEngine( engine ) ) {
+            continue;
+        }
+        uint16_t crc = 0;
+        uint32_t t0 = Now_us();
+        for ( uint32_t r = 0; r < rounds; r++ ) {
+            CRC16 crc16;
+            crc = crc16.Calc_X25( data );
+            _Sink += crc;
+        }
+        uint32_t t1 = Now_us();
+        printf( "%-12s %7lu us, crc %04X%s\r\n", CRC16::EngineName( engine ),
+            (unsigned long)( t1 - t0 ), crc, ( engine == selected ) ? ", selected" : "" );
+    }
+    CRC16::SetEngine( selected );
+}
+
+
+/**
+ * @brief   SLIP encode, SlipEncoder::Encode vs. former byte at a time version
+ *
+ * @param   size    number of payload bytes
+ * @param   rounds  number of rounds
+ */
+void
+Benchmark::SlipEncode( uint16_t size, uint32_t rounds ) {
+
+    if ( size > SerialMessage::Max_Size ) {
+        size = SerialMessage::Max_Size;
+    }
+
+    FixedSerialMessage<>    typical;
+    FixedSerialMessage<>    worst;
+    for ( uint16_t i = 0; i < size; i++ ) {
+        typical.append( (uint8_t)( i * 37 + 11 ) );
+        worst.append( (uint8_t)SlipEncoder::End );
+    }
+
+    //room for the worst case frame
+    static FixedByteArray< 2 * SerialMessage::Max_Size + 2 > output;
+
+    printf( "SLIP encode, %u bytes, %lu rounds\r\n", size, (unsigned long)rounds );
+
+    const SerialMessage* payloads[] = { &typical, &worst };
+    const char*          names[]    = { "typical", "all End" };
+    for ( uint8_t p = 0; p < 2; p++ ) {
+        const SerialMessage& payload = *payloads[p];
+
+        uint32_t t0 = Now_us();
+        for ( uint32_t r = 0; r < rounds; r++ ) {
+            output.clear();
+            _Sink += Encode_Legacy( output, payload ).count();
+        }
+        uint32_t t1 = Now_us();
+        for ( uint32_t r = 0; r < rounds; r++ ) {
+            output.clear();
+            SlipEncoder::Encode( output, payload );
+            _Sink += output.count();
+        }
+        uint32_t t2 = Now_us();
+        printResult( names[p], t1 - t0, t2 - t1, rounds );
+    }
+}
@@ -0,0 +1,66 @@
+/**
+ * @file    Benchmark.h
+ *
+ * @brief   Declaration of class Benchmark
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _Benchmark_H_
+#define _Benchmark_H_
+
+#include <stdint.h>
+
+
+/**
+ * @brief   The Benchmark class provides microbenchmarks which compare
+ *          optimised code paths with reference copies of the former ones.
+ *          Results are printed to stdout.
+ */
+
+class Benchmark {
+
+public:
+
+    //<! default number of rounds per measurement
+    enum {
+        Rounds      =   1000
+    };
+
+    /**
+     * @brief   returns time stamp in microseconds
+     */
+    static uint32_t     Now_us( void );
+
+    /**
+     * @brief   hex encode/decode, HexCodec vs. former SerialMessage/ByteArray functions
+     *
+     * @param   size    number of payload bytes
+     * @param   rounds  number of rounds
+     */
+    static void         HexConversion( uint16_t size = 32, uint32_t rounds = Rounds );
+
+    /**
+     * @brief   CRC16 X.25, all available engines
+     *
+     * @param   size    number of bytes per calculation
+     * @param   rounds  number of rounds
+     */
+    static void         CRC16Engines( uint16_t size = 256, uint32_t rounds = Rounds );
+
+    /**
+     * @brief   SLIP encode, exact-size run-copying SlipEncoder::Encode vs. former
+     *          byte at a time version, typical and worst case (all End) payloads
+     *
+     * @param   size    number of payload bytes
+     * @param   rounds  number of rounds
+     */
+    static void         SlipEncode( uint16_t size = 256, uint32_t rounds = Rounds );
+};
+
+#endif // _Benchmark_H_
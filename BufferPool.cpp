@@ -0,0 +1,243 @@
+/**
+ * @file    BufferPool.cpp
+ *
+ * @brief   Implementation of class BufferPool
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include "BufferPool.h"
+
+#if defined( __ARM_ARCH_6M__ )
+//Cortex-M0/M0+ has no LDREX/STREX, read-modify-write runs with interrupts masked
+#include <Arduino.h>
+
+class IrqLock {
+public:
+    IrqLock( void ) : _PriMask( __get_PRIMASK() ) { __disable_irq(); }
+   ~IrqLock( void ) { __set_PRIMASK( _PriMask ); }
+private:
+    uint32_t _PriMask;
+};
+#endif
+
+
+//<! one pool per size class, bit n of FreeMask set -> block n is free
+struct Pool {
+    uint8_t* const          Storage;
+    const uint16_t          BlockSize;
+    const uint8_t           Blocks;
+    std::atomic<uint32_t>   FreeMask;
+    std::atomic<uint32_t>   HighWater;
+    std::atomic<uint32_t>   Allocations;
+    std::atomic<uint32_t>   Failures;
+};
+
+#define POOL_MASK( n )      ( ( 32 <= ( n ) ) ? 0xFFFFFFFFu : ( ( 1u << ( n ) ) - 1u ) )
+#define POOL_BYTES( n, s )  ( ( n ) ? ( ( n ) * ( s ) ) : 1 )
+
+static_assert( _POOL_BLOCKS_32_  <= 32, "BufferPool: max 32 blocks per class" );
+static_assert( _POOL_BLOCKS_64_  <= 32, "BufferPool: max 32 blocks per class" );
+static_assert( _POOL_BLOCKS_128_ <= 32, "BufferPool: max 32 blocks per class" );
+static_assert( _POOL_BLOCKS_256_ <= 32, "BufferPool: max 32 blocks per class" );
+static_assert( _POOL_BLOCKS_512_ <= 32, "BufferPool: max 32 blocks per class" );
+
+alignas( 8 ) static uint8_t _Storage32 [ POOL_BYTES( _POOL_BLOCKS_32_,   32 ) ];
+alignas( 8 ) static uint8_t _Storage64 [ POOL_BYTES( _POOL_BLOCKS_64_,   64 ) ];
+alignas( 8 ) static uint8_t _Storage128[ POOL_BYTES( _POOL_BLOCKS_128_, 128 ) ];
+alignas( 8 ) static uint8_t _Storage256[ POOL_BYTES( _POOL_BLOCKS_256_, 256 ) ];
+alignas( 8 ) static uint8_t _Storage512[ POOL_BYTES( _POOL_BLOCKS_512_, 512 ) ];
+
+static Pool _Pools[ BufferPool::Classes ] = {
+    { _Storage32,   32, _POOL_BLOCKS_32_,  { POOL_MASK( _POOL_BLOCKS_32_  ) }, { 0 }, { 0 }, { 0 } },
+    { _Storage64,   64, _POOL_BLOCKS_64_,  { POOL_MASK( _POOL_BLOCKS_64_  ) }, { 0 }, { 0 }, { 0 } },
+    { _Storage128, 128, _POOL_BLOCKS_128_, { POOL_MASK( _POOL_BLOCKS_128_ ) }, { 0 }, { 0 }, { 0 } },
+    { _Storage256, 256, _POOL_BLOCKS_256_, { POOL_MASK( _POOL_BLOCKS_256_ ) }, { 0 }, { 0 }, { 0 } },
+    { _Storage512, 512, _POOL_BLOCKS_512_, { POOL_MASK( _POOL_BLOCKS_512_ ) }, { 0 }, { 0 }, { 0 } }
+};
+
+static std::atomic<uint32_t> _Oversized( 0 );
+
+
+/**
+ * @brief   compare and swap
+ *
+ * @param   a           atomic value
+ * @param   expected    expected value, updated with current value on failure
+ * @param   desired     new value
+ *
+ * @return  true if swapped
+ */
+static inline bool
+cas( std::atomic<uint32_t>& a, uint32_t& expected, uint32_t desired ) {
+#if defined( __ARM_ARCH_6M__ )
+    IrqLock lock;
+    uint32_t current = a.load( std::memory_order_relaxed );
+    if ( current != expected ) {
+        expected = current;
+        return false;
+    }
+    a.store( desired, std::memory_order_relaxed );
+    return true;
+#else
+    return a.compare_exchange_weak( expected, desired,
+        std::memory_order_acq_rel, std::memory_order_relaxed );
+#endif
+}
+
+
+/**
+ * @brief   atomic add
+ */
+static inline void
+atomicAdd( std::atomic<uint32_t>& a, uint32_t n ) {
+    uint32_t v = a.load( std::memory_order_relaxed );
+    while ( !cas( a, v, v + n ) ) {
+    }
+}
+
+
+/**
+ * @brief   atomic max
+ */
+static inline void
+atomicMax( std::atomic<uint32_t>& a, uint32_t n ) {
+    uint32_t v = a.load( std::memory_order_relaxed );
+    while ( ( v < n ) && !cas( a, v, n ) ) {
+    }
+}
+
+
+/**
+ * @brief   take a free block from a pool
+ *
+ * @return  pointer to block or nullptr if pool is empty
+ */
+static uint8_t*
+take( Pool& pool ) {
+    uint32_t mask = pool.FreeMask.load( std::memory_order_relaxed );
+    while ( mask ) {
+        uint32_t bit = (uint32_t)__builtin_ctz( mask );
+        uint32_t taken = mask & ~( 1u << bit );
+        if ( cas( pool.FreeMask, mask, taken ) ) {
+            uint32_t inUse = pool.Blocks - (uint32_t)__builtin_popcount( taken );
+            atomicMax( pool.HighWater, inUse );
+            atomicAdd( pool.Allocations, 1 );
+            return pool.Storage + ( bit * pool.BlockSize );
+        }
+    }
+    return nullptr;
+}
+
+
+/**
+ * @brief   allocate a block of at least size bytes
+ *
+ * @param   size        requested size
+ * @param   blocksize   returns real size of the block
+ *
+ * @return  pointer to block, nullptr if no pool can serve the request
+ */
+uint8_t*
+BufferPool::Allocate( uint32_t size, uint16_t& blocksize ) {
+    uint8_t sizeClass = 0;
+    while ( ( sizeClass < Classes ) && ( _Pools[sizeClass].BlockSize < size ) ) {
+        sizeClass++;
+    }
+    if ( Classes == sizeClass ) {
+        atomicAdd( _Oversized, 1 );
+        return nullptr;
+    }
+
+    for ( uint8_t c = sizeClass; c < Classes; c++ ) {
+        uint8_t* block = take( _Pools[c] );
+        if ( block ) {
+            if ( c != sizeClass ) {
+                //served by a larger class, the requested one is too small
+                atomicAdd( _Pools[sizeClass].Failures, 1 );
+            }
+            blocksize = _Pools[c].BlockSize;
+            return block;
+        }
+    }
+    atomicAdd( _Pools[sizeClass].Failures, 1 );
+    return nullptr;
+}
+
+
+/**
+ * @brief   return a block to its pool
+ *
+ * @param   block   pointer returned by Allocate()
+ *
+ * @return  true  - block returned
+ *          false - block is not from a pool, caller must free it
+ */
+bool
+BufferPool::Free( uint8_t* block ) {
+    for ( uint8_t c = 0; c < Classes; c++ ) {
+        Pool& pool = _Pools[c];
+        if ( ( pool.Storage <= block ) && ( block < ( pool.Storage + ( pool.Blocks * pool.BlockSize ) ) ) ) {
+            uint32_t bit = (uint32_t)( block - pool.Storage ) / pool.BlockSize;
+            uint32_t mask = pool.FreeMask.load( std::memory_order_relaxed );
+            while ( !cas( pool.FreeMask, mask, mask | ( 1u << bit ) ) ) {
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief   returns statistics of a size class
+ *
+ * @param   sizeClass   size class
+ * @param   stats       statistics
+ */
+void
+BufferPool::GetStats( uint8_t sizeClass, Stats& stats ) {
+    if ( sizeClass >= Classes ) {
+        stats = Stats();
+        return;
+    }
+    Pool& pool = _Pools[sizeClass];
+    stats.BlockSize     = pool.BlockSize;
+    stats.Blocks        = pool.Blocks;
+    stats.InUse         = pool.Blocks - (uint8_t)__builtin_popcount( pool.FreeMask.load() );
+    stats.HighWater     = (uint8_t)pool.HighWater.load();
+    stats.Allocations   = pool.Allocations.load();
+    stats.Failures      = pool.Failures.load();
+}
+
+
+/**
+ * @return  requests larger than the largest block
+ */
+uint32_t
+BufferPool::GetOversized( void ) {
+    return _Oversized.load();
+}
+
+
+/**
+ * @brief   prints statistics of all size classes
+ */
+void
+BufferPool::print( void ) {
+    Stats stats;
+    for ( uint8_t c = 0; c < Classes; c++ ) {
+        GetStats( c, stats );
+        printf( "Pool %3u: %2u/%2u in use, high water %2u, allocations %lu, failures %lu\r\n",
+            stats.BlockSize, stats.InUse, stats.Blocks, stats.HighWater,
+            (unsigned long)stats.Allocations, (unsigned long)stats.Failures );
+    }
+    printf( "Pool oversized requests: %lu\r\n", (unsigned long)GetOversized() );
+}
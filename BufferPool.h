@@ -0,0 +1,104 @@
+/**
+ * @file    BufferPool.h
+ *
+ * @brief   Declaration of class BufferPool
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _BufferPool_H_
+#define _BufferPool_H_
+
+#include <stdint.h>
+
+
+//<! blocks per size class, max 32 per class, 0 disables a class
+#define _POOL_BLOCKS_32_    8
+#define _POOL_BLOCKS_64_    8
+#define _POOL_BLOCKS_128_   8
+#define _POOL_BLOCKS_256_   8
+#define _POOL_BLOCKS_512_   4
+
+
+/**
+ * @brief   The BufferPool class provides fixed-block pools in a few size classes
+ *          for ByteArray heap storage (and so for Dictionary).
+ *          Allocate() and Free() are lock-free and can be called from
+ *          interrupt context. Storage is static, so its size is known at link time.
+ */
+
+class BufferPool {
+
+public:
+
+    //<! size classes
+    enum SizeClass : uint8_t {
+        Class_32        =   0,
+        Class_64,
+        Class_128,
+        Class_256,
+        Class_512,
+        Classes
+    };
+
+    //<! bytes of the largest block
+    static constexpr uint16_t   Max_Block_Size  =   512;
+
+    //<! statistics of a size class
+    struct Stats {
+        uint16_t    BlockSize;      //!< bytes per block
+        uint8_t     Blocks;         //!< blocks in pool
+        uint8_t     InUse;          //!< blocks currently in use
+        uint8_t     HighWater;      //!< max blocks in use ever
+        uint32_t    Allocations;    //!< successful allocations
+        uint32_t    Failures;       //!< requests for this class which found it empty
+    };
+
+    /**
+     * @brief   allocate a block of at least size bytes
+     *
+     * @param   size        requested size
+     * @param   blocksize   returns real size of the block
+     *
+     * @return  pointer to block, nullptr if no pool can serve the request
+     *
+     * @note    a full size class falls back to the next larger one,
+     *          the failure is counted for the requested class
+     */
+    static uint8_t*     Allocate( uint32_t size, uint16_t& blocksize );
+
+    /**
+     * @brief   return a block to its pool
+     *
+     * @param   block   pointer returned by Allocate()
+     *
+     * @return  true  - block returned
+     *          false - block is not from a pool, caller must free it
+     */
+    static bool         Free( uint8_t* block );
+
+    /**
+     * @brief   returns statistics of a size class
+     *
+     * @param   sizeClass   size class
+     * @param   stats       statistics
+     */
+    static void         GetStats( uint8_t sizeClass, Stats& stats );
+
+    /**
+     * @return  requests larger than the largest block
+     */
+    static uint32_t     GetOversized( void );
+
+    /**
+     * @brief   prints statistics of all size classes
+     */
+    static void         print( void );
+};
+
+#endif // _BufferPool_H_
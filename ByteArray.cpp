@@ -15,7 +15,10 @@
 #include <cstring>
 #include <stdio.h>
 #include <algorithm>    //std::min
+#include <new>          //std::nothrow
 #include "ByteArray.h"
+#include "BufferPool.h"
+#include "HexCodec.h"
 
 
 /**
@@ -24,17 +27,18 @@
   * @param  -
  */
 ByteArray::ByteArray( void ) :
-    _size( 0 ), _count( 0 ), _data( (uint8_t*)nullptr ) {
+    _data( nullptr ), _size( 0 ), _count( 0 ), _fixed( false ), _arena( nullptr ), _inline( nullptr ) {
 }
 
 
 /**
   * @brief  class constructor, not initialised buffer
   *
-  * @param  buffersize  buffer size
+  * @param  buffersize  initial buffer size, the array grows if needed
  */
 ByteArray::ByteArray( uint16_t buffersize ) :
-    _size( buffersize ), _count( 0 ), _data( new uint8_t[(size_t)buffersize] ) {
+    _data( nullptr ), _size( 0 ), _count( 0 ), _fixed( false ), _arena( nullptr ), _inline( nullptr ) {
+    reserve( buffersize );
 }
 
 
@@ -42,10 +46,13 @@ ByteArray::ByteArray( uint16_t buffersize ) :
   * @brief  class constructor, size, pointe to buffer
   *
   * @param  size  buffer size, it all contains data
-  *         dataptr  pointer to buffer
+  *         dataptr  pointer to buffer allocated with new[], ownership is taken
  */
 ByteArray::ByteArray( uint16_t size, uint8_t* dataptr ) :
-    _size( size ), _count( size ), _data( dataptr ) {
+    _data( dataptr ),
+    _size( dataptr ? size : 0 ),
+    _count( dataptr ? size : 0 ),
+    _fixed( false ), _arena( nullptr ), _inline( nullptr ) {
 }
 
 
@@ -54,10 +61,54 @@ ByteArray::ByteArray( uint16_t size, uint8_t* dataptr ) :
   *
   * @param  size  buffer size, it all contains data
   *         filled  useful data bytes count
-  *         dataptr  pointer to buffer
+  *         dataptr  pointer to buffer allocated with new[], ownership is taken
  */
 ByteArray::ByteArray( uint16_t size,  uint16_t filled, uint8_t* dataptr ) :
-    _size( size ), _count( filled ), _data( dataptr ) {
+    _data( dataptr ),
+    _size( dataptr ? size : 0 ),
+    _count( dataptr ? std::min( size, filled ) : 0 ),
+    _fixed( false ), _arena( nullptr ), _inline( nullptr ) {
+}
+
+
+/**
+  * @brief  class constructor on caller-provided storage, the array
+  *         never grows beyond buffersize and never frees the storage
+  *
+  * @param  storage     ByteArray::Fixed
+  *         buffer      caller-provided storage
+  *         buffersize  storage size
+ */
+ByteArray::ByteArray( Storage storage, uint8_t* buffer, uint16_t buffersize ) :
+    _data( buffer ),
+    _size( buffer ? buffersize : 0 ),
+    _count( 0 ),
+    _fixed( Fixed == storage ),
+    _arena( nullptr ),
+    _inline( nullptr ) {
+}
+
+
+/**
+  * @brief  class constructor on small-buffer storage, see SmallByteArray
+  *
+  * @param  buffer      Inline_Size bytes of inline storage of the derived class
+ */
+ByteArray::ByteArray( uint8_t* buffer ) :
+    _data( buffer ), _size( Inline_Size ), _count( 0 ), _fixed( false ), _arena( nullptr ), _inline( buffer ) {
+}
+
+
+/**
+  * @brief  class constructor on arena storage, the array grows into the
+  *         arena and never frees, the arena releases it by Reset()
+  *
+  * @param  arena       arena outliving the array contents
+  *         buffersize  initial buffer size, the array grows if needed
+ */
+ByteArray::ByteArray( Arena& arena, uint16_t buffersize ) :
+    _data( nullptr ), _size( 0 ), _count( 0 ), _fixed( false ), _arena( &arena ), _inline( nullptr ) {
+    reserve( buffersize );
 }
 
 
@@ -68,9 +119,8 @@ ByteArray::ByteArray( uint16_t size,  uint16_t filled, uint8_t* dataptr ) :
   *         c         character
  */
 ByteArray::ByteArray( uint16_t repeats, char c ) :
-    _size( repeats ), _count( repeats ), _data( new uint8_t[(size_t)repeats] ) {
-    //std::memset( _data, c, (size_t)repeats);  //?
-    std::memset( const_cast<uint8_t*>( _data ), c, (size_t)repeats );
+    _data( nullptr ), _size( 0 ), _count( 0 ), _fixed( false ), _arena( nullptr ), _inline( nullptr ) {
+    append( repeats, (uint8_t)c );
 }
 
 
@@ -80,8 +130,8 @@ ByteArray::ByteArray( uint16_t repeats, char c ) :
   * @param  aString
  */
 ByteArray::ByteArray( const std::string& aString ) :
-    _size( aString.size() ), _count( aString.size() ), _data( new uint8_t[aString.size()] ) {
-    std::memcpy( _data, aString.data(), aString.size() );
+    _data( nullptr ), _size( 0 ), _count( 0 ), _fixed( false ), _arena( nullptr ), _inline( nullptr ) {
+    append( (const uint8_t*)aString.data(), (uint16_t)std::min( aString.size(), (size_t)Max_Size ) );
 }
 
 
@@ -91,8 +141,19 @@ ByteArray::ByteArray( const std::string& aString ) :
   * @param  aString
  */
 ByteArray::ByteArray( std::string&& aString ) :
-    _size( aString.size() ), _count( aString.size() ), _data( new uint8_t[aString.size()] ) {
-    std::memcpy( _data, aString.data(), aString.size() );
+    _data( nullptr ), _size( 0 ), _count( 0 ), _fixed( false ), _arena( nullptr ), _inline( nullptr ) {
+    append( (const uint8_t*)aString.data(), (uint16_t)std::min( aString.size(), (size_t)Max_Size ) );
+}
+
+
+/**
+  * @brief  class constructor, owning copy of a view
+  *
+  * @param  aView   viewed bytes to copy
+ */
+ByteArray::ByteArray( const ByteArrayView& aView ) :
+    _data( nullptr ), _size( 0 ), _count( 0 ), _fixed( false ), _arena( nullptr ), _inline( nullptr ) {
+    append( aView );
 }
 
 
@@ -103,27 +164,30 @@ ByteArray::ByteArray( std::string&& aString ) :
   * @param  aByteArray   input ByteArray
  */
 ByteArray::ByteArray( const ByteArray& other ) :
-    _size( other._count ),
-    _count( other._count ),
-    _data( new uint8_t[other._count] ) {
-    std::memcpy( _data, other._data, _count );
+    _data( nullptr ), _size( 0 ), _count( 0 ), _fixed( false ), _arena( nullptr ), _inline( nullptr ) {
+    append( other._data, other._count );
 }
 
 
 /**
-  * @brief  move constructor
+  * @brief  move constructor, heap storage is taken over,
+  *         inline and fixed storage is copied
   *
   * @param  ByteArray& aByteArray
   */
 ByteArray::ByteArray( ByteArray&& other ) noexcept :
-    _size( other._size ),
-    _count( other._count ),
-    _data( other._data ) {
-    //overtake aByteArray._data, overtake aByteArray._size
-    //invalidate
-    //aByteArray._data  = nullptr;    //*const
-    const_cast<uint8_t*&>( other._data ) = nullptr; //const_cast
-    other._size  = 0;
+    _data( nullptr ), _size( 0 ), _count( 0 ), _fixed( false ), _arena( nullptr ), _inline( nullptr ) {
+    if ( other.isHeap() ) {
+        //overtake other._data and other._size
+        _data  = other._data;
+        _size  = other._size;
+        _count = other._count;
+        //invalidate
+        other.fallback();
+    } else {
+        //inline or fixed storage can not be taken over
+        append( other._data, other._count );
+    }
     other._count = 0;
 }
 
@@ -134,7 +198,7 @@ ByteArray::ByteArray( ByteArray&& other ) noexcept :
   * @param  -
  */
 ByteArray::~ByteArray( void ) {
-    delete[] _data;
+    release();
 }
 
 
@@ -147,8 +211,8 @@ ByteArray::~ByteArray( void ) {
 ByteArray&
 ByteArray::operator = ( const ByteArray& other ) {
     if ( this != &other ) {
-        _count = std::min( _size, other._count );
-        std::memcpy( _data, other._data, _count );
+        _count = 0;
+        append( other._data, other._count );
     }
     return *this;
 }
@@ -162,21 +226,147 @@ ByteArray::operator = ( const ByteArray& other ) {
 ByteArray&
 ByteArray::operator = ( ByteArray&& other ) noexcept {
     if ( this != &other ) {
-        //_size can not be changed since memory is already taken
-        _count = std::min( _size, other._count );
-        //the object is already made. _data is  *const
-        //delete[] _data;
-        //_data  = aByteArray._data;
-        std::memcpy( _data, other._data, _count );
-        //aByteArray._data  = nullptr;  //not alloved for *const
-        //at least correct the properties aka invalidate
-        other._size  = 0;
+        if ( other.isHeap() && !_fixed && !_arena ) {
+            release();
+            //overtake other._data and other._size
+            _data  = other._data;
+            _size  = other._size;
+            _count = other._count;
+            //invalidate
+            other.fallback();
+        } else {
+            //fixed storage stays in place, data is copied
+            _count = 0;
+            append( other._data, other._count );
+        }
         other._count = 0;
     }
     return *this;
 }
 
 
+/**
+ * @brief   releases heap storage and falls back to inline storage, if any
+ *
+ * @param   -
+ *
+ * @return  -
+ */
+void
+ByteArray::release( void ) {
+    if ( isHeap() ) {
+        if ( !BufferPool::Free( _data ) ) {
+            delete[] _data;
+        }
+        fallback();
+    } else if ( _arena ) {
+        //arena storage is released by the arena
+        fallback();
+    }
+    _count = 0;
+}
+
+
+/**
+ * @brief   points the array to its inline storage, none for a plain ByteArray
+ *
+ * @param   -
+ *
+ * @return  -
+ */
+void
+ByteArray::fallback( void ) {
+    _data  = _inline;
+    _size  = _inline ? (uint16_t)Inline_Size : 0;
+}
+
+
+/**
+ * @brief   makes sure the array can hold at least newsize bytes,
+ *          grows geometrically to keep appends amortized O(1), near the
+ *          limit of the pool or arena it grows to newsize only
+ *
+ * @param   newsize     required array size
+ *
+ * @return  true  - array size is >= newsize
+ *          false - out of memory or newsize exceeds Max_Size
+ */
+bool
+ByteArray::reserve( uint32_t newsize ) {
+    if ( newsize <= _size ) {
+        return true;
+    }
+    if ( _fixed || ( newsize > Max_Size ) ) {
+        return false;
+    }
+
+    uint32_t grown = (uint32_t)_size << 1;
+    if ( grown < newsize ) {
+        grown = newsize;
+    } else if ( grown > Max_Size ) {
+        grown = Max_Size;
+    }
+
+#if 0 == _BYTEARRAY_HEAP_
+    //without heap a pool block or an arena chunk is the limit
+    uint32_t limit = _arena ? Arena::GetMaxAllocation() : BufferPool::Max_Block_Size;
+    if ( ( grown > limit ) && ( newsize <= limit ) ) {
+        grown = limit;
+    }
+#endif
+
+    //the last arena allocation grows in place, no copy
+    if ( _arena && _data && ( _data != _inline ) ) {
+        if ( _arena->Extend( _data, (uint16_t)grown ) ) {
+            _size = (uint16_t)grown;
+            return true;
+        }
+        if ( _arena->Extend( _data, (uint16_t)newsize ) ) {
+            _size = (uint16_t)newsize;
+            return true;
+        }
+    }
+
+    //the doubled size first, then exactly newsize
+    uint8_t* pnew = nullptr;
+    for ( ;; ) {
+        if ( _arena ) {
+            //the old storage stays in the arena until its Reset()
+            pnew = _arena->Allocate( (uint16_t)grown );
+        } else {
+            //pool blocks first, use the whole block
+            uint16_t blocksize = 0;
+            pnew = BufferPool::Allocate( grown, blocksize );
+            if ( pnew ) {
+                grown = blocksize;
+            }
+#if 0 != _BYTEARRAY_HEAP_
+            else {
+                pnew = new (std::nothrow) uint8_t[grown];
+            }
+#endif
+        }
+        if ( pnew ) {
+            break;
+        }
+        if ( grown == newsize ) {
+            return false;
+        }
+        grown = newsize;
+    }
+    if ( _count ) {
+        std::memcpy( pnew, _data, _count );
+    }
+
+    uint16_t keep = _count;
+    release();
+    _data  = pnew;
+    _size  = (uint16_t)grown;
+    _count = keep;
+    return true;
+}
+
+
 /**
  * @brief   returns data buffer
  *
@@ -269,15 +459,15 @@ ByteArray::at( int index ) const {
 }
 
 /**
- * @brief   returns ByteArray
+ * @brief   appends abyte, grows the array if needed
  *
  * @param   byte  byte to append
  *
- * @return  ByteArray
+ * @return  reference to this ByteArray
  */
-ByteArray
+ByteArray&
 ByteArray::append( uint8_t abyte ) {
-    if ( _count < _size ) {
+    if ( ( _count < _size ) || reserve( (uint32_t)_count + 1 ) ) {
         _data[_count++] = abyte;
     }
     return *this;
@@ -285,59 +475,91 @@ ByteArray::append( uint8_t abyte ) {
 
 
 /**
- * @brief   returns ByteArray
+ * @brief   appends abyte x repeats, grows the array if needed
  *
  * @param   repeats byte repeats
  *          byte    byte to append
  *
- * @return  ByteArray
+ * @return  reference to this ByteArray
  */
-ByteArray
+ByteArray&
 ByteArray::append( int repeats, uint8_t abyte ) {
-    int i = repeats;
-    while ( ( 0 < i-- ) && ( _count < _size ) ) {
-        _data[_count++] = abyte;
+    if ( ( 0 < repeats ) && reserve( (uint32_t)_count + repeats ) ) {
+        std::memset( _data + _count, abyte, repeats );
+        _count += repeats;
     }
     return *this;
 }
 
 
 /**
- * @brief   return ByteArray converted form HEX
+ * @brief   appends n bytes in one copy, grows the array if needed
  *
- * @param   hexEncoded  HEX encoded array
+ * @param   dataptr pointer to bytes to append
+ *          n       number of bytes
  *
- * @return  ByteArray converted form HEX
+ * @return  reference to this ByteArray
  */
-ByteArray
-ByteArray::fromHex( const ByteArray &hexEncoded ) const {
+ByteArray&
+ByteArray::append( const uint8_t* dataptr, uint16_t n ) {
+    if ( ( 0 == n ) || ( nullptr == dataptr ) ) {
+        return *this;
+    }
+    //dataptr may point into this array, keep it valid across reserve()
+    if ( ( _data <= dataptr ) && ( dataptr < ( _data + _size ) ) ) {
+        uint16_t offset = (uint16_t)( dataptr - _data );
+        if ( reserve( (uint32_t)_count + n ) ) {
+            std::memmove( _data + _count, _data + offset, n );
+            _count += n;
+        }
+    } else if ( reserve( (uint32_t)_count + n ) ) {
+        std::memcpy( _data + _count, dataptr, n );
+        _count += n;
+    }
+    return *this;
+}
+
+
+/**
+ * @brief   appends viewed bytes in one copy, grows the array if needed
+ *
+ * @param   aView   bytes to append
+ *
+ * @return  reference to this ByteArray
+ */
+ByteArray&
+ByteArray::append( const ByteArrayView& aView ) {
+    return append( aView.data(), aView.count() );
+}
 
-    ByteArray tfromHex( ( hexEncoded._count >> 1 ) + ( hexEncoded._count & 1 ) );
 
-    for ( uint16_t i = 0; i < tfromHex._count; i++ ) {
-        uint16_t j = 0;
-        uint8_t abyte = 0;
+/**
+ * @brief   appends other ByteArray in one copy, grows the array if needed
+ *
+ * @param   other   bytes to append
+ *
+ * @return  reference to this ByteArray
+ */
+ByteArray&
+ByteArray::append( const ByteArray& other ) {
+    return append( other._data, other._count );
+}
 
-        uint8_t hexb = hexEncoded.at( j++ );
-        if ( ( '0' <= hexb ) && ( hexb <= '9' ) ) {
-            abyte += hexb - '0';
-        } else if ( ( 'a' <= hexb ) && ( hexb <= 'f' ) ) {
-            abyte += hexb - 'a' + 10;
-        } else if ( ( 'A' <= hexb ) && ( hexb <= 'F' ) ) {
-            abyte += hexb - 'a' + 10;
-        }
-        abyte = abyte << 4;
-
-        hexb = hexEncoded.at( j++ );
-        if ( ( '0' <= hexb ) && ( hexb <= '9' ) ) {
-            abyte += hexb - '0';
-        } else if ( ( 'a' <= hexb ) && ( hexb <= 'f' ) ) {
-            abyte += hexb - 'a' + 10;
-        } else if ( ( 'A' <= hexb ) && ( hexb <= 'F' ) ) {
-            abyte += hexb - 'a' + 10;
-        }
 
-        tfromHex.append( abyte );
+/**
+ * @brief   return ByteArray converted form HEX, non-hex characters are skipped
+ *
+ * @param   hexEncoded  HEX encoded array
+ *
+ * @return  ByteArray converted form HEX
+ */
+ByteArray
+ByteArray::fromHex( const ByteArray &hexEncoded ) {
+
+    ByteArray tfromHex;
+    if ( tfromHex.reserve( ( hexEncoded._count >> 1 ) + ( hexEncoded._count & 1 ) ) ) {
+        tfromHex._count = HexCodec::Decode( tfromHex._data, tfromHex._size,
+            reinterpret_cast<const char*>( hexEncoded._data ), hexEncoded._count );
     }
     return tfromHex;
 }
@@ -368,39 +590,16 @@ ByteArray::fromString( const std::string &aString ) {
  * @brief   returns middle from ByteArray
  *
  * @param   index   first byte (0 based)
- *          size    size of returnned array, -1 means rest starting from index
+ *          size    size of returnned view, -1 means rest starting from index
  *
- * @return  ByteArray
+ * @return  ByteArrayView into this array, valid until the array is modified
  */
-ByteArray
+ByteArrayView
 ByteArray::mid( uint16_t index, int size ) const {
-    //optimizeet!
-    if ( size > 0 ) {
-
-        ByteArray temp( size );
-        for ( uint16_t i = index; i < ( index + size ); i++ ) {
-            if ( i < _count ) {
-                temp.append( at( i ) );
-            } else {
-                break;
-            }
-        }
-        return temp;
-
-    } else if ( size < 0 ) {
-
-        int aSize = _count - index;
-        if ( aSize > 0 ) {
-            ByteArray temp( aSize );
-            for ( uint16_t i = index; i < ( index + aSize ); i++ ) {
-                temp.append( at( i ) );
-            }
-            return temp;
-        }
+    if ( 0 == size ) {
+        return ByteArrayView();
     }
-
-    return ByteArray();
-
+    return ByteArrayView( _data, _count ).mid( index, size );
 }
 
 
@@ -410,9 +609,9 @@ ByteArray::mid( uint16_t index, int size ) const {
  *
  * @param   n   bytes to remove rom the end
  *
- * @return  ByteArray
+ * @return  reference to this ByteArray
  */
-ByteArray
+ByteArray&
 ByteArray::chop( int n ) {
     if ( n > _count ) {
         _count = 0;
@@ -17,6 +17,11 @@
 #include <string>   //cpp string
 #include <stdint.h>
 #include <stdio.h>  //c printf
+#include "ByteArrayView.h"
+#include "Arena.h"
+
+
+#define _BYTEARRAY_HEAP_ 1  //1: arrays grow into BufferPool, then heap, 0: BufferPool only, no new[]
 
 //#include <USBSerial.h>
 //#include "HardwareSerial.h"
@@ -24,11 +29,25 @@
 
 /**
  * @brief   The ByteArray class provides methods for ByteArray.
+ *          Arrays grow geometrically into BufferPool blocks, then on the
+ *          heap, or into an Arena if one is given. ByteArray has no inline
+ *          storage of its own: SmallByteArray adds it, fixed arrays bring
+ *          exactly their capacity.
  */
 
 class ByteArray {
     public:
 
+        enum {
+            Inline_Size =   64,     //!< inline storage of SmallByteArray, covers most HCI frames
+            Max_Size    =   0xFFFF  //!< size and count are uint16_t
+        };
+
+        //<! storage policy for caller-provided storage
+        enum Storage : uint8_t {
+            Fixed       =   1       //!< never grows, never freed by ByteArray
+        };
+
         /**
           * @brief  class constructor for empty instance
           *
@@ -39,7 +58,7 @@ class ByteArray {
         /**
           * @brief  class constructor, not initialised buffer
           *
-          * @param  buffersize  buffer size
+          * @param  buffersize  initial buffer size, the array grows if needed
           */
                     ByteArray( uint16_t buffersize );
 
@@ -47,7 +66,7 @@ class ByteArray {
           * @brief  class constructor, size, pointe to buffer
           *
           * @param  size  buffer size, it all contains data
-          *         dataptr  pointer to buffer
+          *         dataptr  pointer to buffer allocated with new[], ownership is taken
           */
                     ByteArray( uint16_t size, uint8_t* dataptr );
 
@@ -56,10 +75,29 @@ class ByteArray {
           *
           * @param  size  buffer size, it all contains data
           *         filled  useful data bytes count
-          *         dataptr  pointer to buffer
+          *         dataptr  pointer to buffer allocated with new[], ownership is taken
           */
                     ByteArray( uint16_t size, uint16_t filled, uint8_t* dataptr );
 
+        /**
+          * @brief  class constructor on caller-provided storage, the array
+          *         never grows beyond buffersize and never frees the storage
+          *
+          * @param  storage     ByteArray::Fixed
+          *         buffer      caller-provided storage
+          *         buffersize  storage size
+          */
+                    ByteArray( Storage storage, uint8_t* buffer, uint16_t buffersize );
+
+        /**
+          * @brief  class constructor on arena storage, the array grows into the
+          *         arena and never frees, the arena releases it by Reset()
+          *
+          * @param  arena       arena outliving the array contents
+          *         buffersize  initial buffer size, the array grows if needed
+          */
+                    ByteArray( Arena& arena, uint16_t buffersize );
+
         /**
           * @brief  class constructor, initialised repeating a char
           *
@@ -82,6 +120,13 @@ class ByteArray {
          */
                     ByteArray( std::string&& aString );
 
+        /**
+          * @brief  class constructor, owning copy of a view
+          *
+          * @param  aView   viewed bytes to copy
+         */
+        explicit    ByteArray( const ByteArrayView& aView );
+
         /**
           * @brief  class copy constructor, initialised using const ByteArray,
           *         _size is reduced to _count
@@ -118,6 +163,13 @@ class ByteArray {
           */
         ByteArray& operator = ( ByteArray&& other ) noexcept;
 
+        /**
+          * @brief  conversion to non-owning view of the data, no copy
+          *
+          * @param  -
+          */
+                    operator ByteArrayView () const { return ByteArrayView( _data, _count ); }
+
         /**
          * @brief   returns data buffer
          *
@@ -145,6 +197,25 @@ class ByteArray {
          */
         uint16_t    size( void ) const;
 
+        /**
+         * @brief   true if the array can not grow beyond size()
+         *
+         * @param   -
+         *
+         * @return  true/false
+         */
+        bool        isFixed( void ) const { return _fixed; }
+
+        /**
+         * @brief   makes sure the array can hold at least newsize bytes
+         *
+         * @param   newsize     required array size
+         *
+         * @return  true  - array size is >= newsize
+         *          false - out of memory or newsize exceeds Max_Size
+         */
+        bool        reserve( uint32_t newsize );
+
         /**
          * @brief   clears the contents of the byte array and makes it null
          *
@@ -183,42 +254,70 @@ class ByteArray {
         uint8_t     at( int index ) const;
 
         /**
-         * @brief   incoming ByteArray with added abyte
+         * @brief   appends abyte, grows the array if needed
          *
          * @param   byte  byte to append
          *
-         * @return  byte count in array
+         * @return  reference to this ByteArray
          */
-        ByteArray   append( uint8_t abyte );
+        ByteArray&  append( uint8_t abyte );
 
         /**
-         * @brief   incoming ByteArray with added abyte x repeats
+         * @brief   appends abyte x repeats, grows the array if needed
          *
          * @param   repeats byte repeats
          *          byte    byte to append
          *
-         * @return  byte count in array
+         * @return  reference to this ByteArray
+         */
+        ByteArray&  append( int repeats, uint8_t abyte );
+
+        /**
+         * @brief   appends n bytes in one copy, grows the array if needed
+         *
+         * @param   dataptr pointer to bytes to append
+         *          n       number of bytes
+         *
+         * @return  reference to this ByteArray
+         */
+        ByteArray&  append( const uint8_t* dataptr, uint16_t n );
+
+        /**
+         * @brief   appends viewed bytes in one copy, grows the array if needed
+         *
+         * @param   aView   bytes to append
+         *
+         * @return  reference to this ByteArray
          */
-        ByteArray   append( int repeats, uint8_t abyte );
+        ByteArray&  append( const ByteArrayView& aView );
 
         /**
-         * @brief   return ByteArray converted form HEX
+         * @brief   appends other ByteArray in one copy, grows the array if needed
+         *
+         * @param   other   bytes to append
+         *
+         * @return  reference to this ByteArray
+         */
+        ByteArray&  append( const ByteArray& other );
+
+        /**
+         * @brief   return ByteArray converted form HEX, non-hex characters are skipped
          *
          * @param   hexEncoded  HEX encoded array
          *
          * @return  ByteArray converted form HEX
          */
-        ByteArray   fromHex( const ByteArray &hexEncoded ) const;
+        static ByteArray    fromHex( const ByteArray &hexEncoded );
 
         /**
-         * @brief   returns mid
+         * @brief   returns mid as a view into this array, no data is copied
          *
          * @param   uint16_t index
          *          int size
          *
-         * @return  ByteArray
+         * @return  ByteArrayView
          */
-        ByteArray   mid( uint16_t index, int size ) const;
+        ByteArrayView   mid( uint16_t index, int size ) const;
 
         /**
          * @brief   Removes n bytes from the end of the byte array.
@@ -226,9 +325,9 @@ class ByteArray {
          *
          * @param   n   bytes to remove rom the end
          *
-         * @return  ByteArray
+         * @return  reference to this ByteArray
          */
-        ByteArray   chop( int n );
+        ByteArray&  chop( int n );
 
         /**
          * @brief   prints the buffer ar chars
@@ -248,13 +347,106 @@ class ByteArray {
          */
 //        void        print( USBSerial Serial ) const;
 
+    protected:
+
+        /**
+          * @brief  class constructor on small-buffer storage, see SmallByteArray
+          *
+          * @param  buffer      Inline_Size bytes of inline storage of the derived class
+          */
+        explicit    ByteArray( uint8_t* buffer );
+
     private:
+
+        /**
+         * @brief   true if _data points to heap storage
+         */
+        bool        isHeap( void ) const { return _data && ( _data != _inline ) && !_fixed && !_arena; }
+
+        /**
+         * @brief   releases heap storage and falls back to inline storage, if any
+         */
+        void        release( void );
+
+        /**
+         * @brief   points the array to its inline storage, none for a plain ByteArray
+         */
+        void        fallback( void );
+
+        //<! data, _inline, pool, heap, arena or caller-provided
+        uint8_t*        _data;
         //<! size
         uint16_t        _size;
         //<! count
         uint16_t        _count;
-        //<! data
-        uint8_t* const  _data;
+        //<! storage is caller-provided or inline, the array can not grow
+        bool            _fixed;
+        //<! arena of the storage, nullptr for inline, pool or heap storage
+        Arena*          _arena;
+        //<! inline storage of a SmallByteArray, nullptr otherwise
+        uint8_t*        _inline;
+};
+
+
+/**
+ * @brief   The SmallByteArray class is a ByteArray with Inline_Size bytes of
+ *          inline storage, small arrays do not allocate.
+ */
+
+class SmallByteArray : public ByteArray {
+    public:
+
+        /**
+          * @brief  class constructor for empty instance
+          */
+                    SmallByteArray( void ) : ByteArray( _small ) {}
+
+        /**
+          * @brief  class constructor, copy of a view
+          *
+          * @param  aView   bytes to copy
+          */
+        explicit    SmallByteArray( const ByteArrayView& aView ) : ByteArray( _small ) {
+                        append( aView );
+                    }
+
+        /**
+          * @brief  class copy constructor
+          *
+          * @param  other   array to copy
+          */
+                    SmallByteArray( const SmallByteArray& other ) : ByteArray( _small ) {
+                        append( other );
+                    }
+
+        /**
+          * @brief  move constructor, heap storage is taken over
+          *
+          * @param  other   array to move from
+          */
+                    SmallByteArray( SmallByteArray&& other ) noexcept : ByteArray( _small ) {
+                        ByteArray::operator = ( static_cast< ByteArray&& >( other ) );
+                    }
+
+        /**
+          * @brief  copy assignment operator
+          */
+        SmallByteArray& operator = ( const SmallByteArray& other ) {
+                        ByteArray::operator = ( other );
+                        return *this;
+                    }
+
+        /**
+          * @brief  move assignment operator
+          */
+        SmallByteArray& operator = ( SmallByteArray&& other ) noexcept {
+                        ByteArray::operator = ( static_cast< ByteArray&& >( other ) );
+                        return *this;
+                    }
+
+    private:
+        //<! inline storage
+        uint8_t         _small[ Inline_Size ];
 };
 
 #endif // _ByteArray_H_
@@ -0,0 +1,38 @@
+/**
+ * @file    ByteArrayView.cpp
+ *
+ * @brief   Implementation of class ByteArrayView
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include "ByteArrayView.h"
+
+
+/**
+ * @brief   returns sub-view, no data is copied
+ *
+ * @param   index   first byte (0 based)
+ *          size    size of returned view, -1 means rest starting from index
+ *
+ * @return  ByteArrayView, empty if index is out of view
+ */
+ByteArrayView
+ByteArrayView::mid( uint16_t index, int size ) const {
+
+    if ( index >= _count ) {
+        return ByteArrayView();
+    }
+
+    int rest = _count - index;
+    if ( ( size < 0 ) || ( size > rest ) ) {
+        size = rest;
+    }
+
+    return ByteArrayView( _data + index, (uint16_t)size );
+}
@@ -0,0 +1,109 @@
+/**
+ * @file    ByteArrayView.h
+ *
+ * @brief   Declaration of class ByteArrayView
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _ByteArrayView_H_
+#define _ByteArrayView_H_
+
+#include <stdint.h>
+
+
+/**
+ * @brief   The ByteArrayView class is a non-owning view (pointer + length)
+ *          into a byte buffer owned by someone else, e.g. a ByteArray.
+ *
+ * @note    a view never allocates or copies, it is only valid as long as
+ *          the viewed buffer is alive and not modified
+ */
+
+class ByteArrayView {
+    public:
+
+        /**
+          * @brief  class constructor for empty view
+          *
+          * @param  -
+          */
+                    ByteArrayView( void ) : _data( nullptr ), _count( 0 ) {}
+
+        /**
+          * @brief  class constructor, pointer to buffer and size
+          *
+          * @param  dataptr  pointer to first byte
+          *         count    number of bytes in view
+          */
+                    ByteArrayView( const uint8_t* dataptr, uint16_t count ) :
+                        _data( dataptr ), _count( dataptr ? count : 0 ) {}
+
+        /**
+         * @brief   returns pointer to the first byte of the view
+         *
+         * @param   -
+         *
+         * @return  pointer to viewed data
+         */
+        const uint8_t*  data( void ) const { return _data; }
+
+        /**
+         * @brief   returns size of data in view
+         *
+         * @param   -
+         *
+         * @return  viewed data size
+         */
+        uint16_t    count( void ) const { return _count; }
+
+        /**
+         * @brief   returns true if view is empty
+         *
+         * @param   -
+         *
+         * @return  true/false
+         */
+        bool        isEmpty( void ) const { return 0 == _count; }
+
+        /**
+         * @brief   return byte at index, bounds checked
+         *
+         * @param   index  view index
+         *
+         * @return  byte at position index, 0 if out of view
+         */
+        uint8_t     at( uint16_t index ) const { return ( index < _count ) ? _data[index] : 0; }
+
+        /**
+         * @brief   return byte at index, not bounds checked
+         *
+         * @param   index  view index
+         *
+         * @return  byte at position index
+         */
+        uint8_t     operator [] ( uint16_t index ) const { return _data[index]; }
+
+        /**
+         * @brief   returns sub-view, no data is copied
+         *
+         * @param   index   first byte (0 based)
+         *          size    size of returned view, -1 means rest starting from index
+         *
+         * @return  ByteArrayView
+         */
+        ByteArrayView   mid( uint16_t index, int size = -1 ) const;
+
+    private:
+        //<! data
+        const uint8_t*  _data;
+        //<! count
+        uint16_t        _count;
+};
+
+#endif // _ByteArrayView_H_
@@ -12,8 +12,13 @@
  * Gatis Gaigals @ EDI, 2024 
  */
 
+#include <string.h>
 #include "CRC16.h"
 
+#if 0 != _CRC16_CLMUL_
+#include <immintrin.h>
+#endif
+
 const uint16_t
 CRC16::_Table[] = {
     0x0000, 0x1189, 0x2312, 0x329B, 0x4624, 0x57AD, 0x6536, 0x74BF,
@@ -50,6 +55,42 @@ CRC16::_Table[] = {
     0x7BC7, 0x6A4E, 0x58D5, 0x495C, 0x3DE3, 0x2C6A, 0x1EF1, 0x0F78,
 };
 
+#if 0 != _CRC16_SLICE_BY_
+
+static_assert( ( 4 == _CRC16_SLICE_BY_ ) || ( 8 == _CRC16_SLICE_BY_ ), "CRC16: _CRC16_SLICE_BY_ must be 0, 4 or 8" );
+
+//<! slicing tables: Slice[k-1][i] is crc of byte i followed by k zero bytes, generated at compile time
+struct CRC16Slices {
+    uint16_t    Slice[ _CRC16_SLICE_BY_ - 1 ][256];
+
+    constexpr CRC16Slices() : Slice() {
+        uint16_t table[256] = {};
+        for ( int i = 0; i < 256; i++ ) {
+            uint16_t crc = (uint16_t)i;
+            for ( int bit = 0; bit < 8; bit++ ) {
+                crc = ( crc & 1 ) ? (uint16_t)( ( crc >> 1 ) ^ CRC16::Polynom ) : (uint16_t)( crc >> 1 );
+            }
+            table[i] = crc;
+        }
+        for ( int i = 0; i < 256; i++ ) {
+            uint16_t crc = table[i];
+            for ( int k = 0; k < ( _CRC16_SLICE_BY_ - 1 ); k++ ) {
+                crc = (uint16_t)( ( crc >> 8 ) ^ table[ crc & 0x00FF ] );
+                Slice[k][i] = crc;
+            }
+        }
+    }
+};
+
+static constexpr CRC16Slices _Slices;
+
+#endif
+
+
+CRC16::Engine
+CRC16::_Engine = CRC16::bestEngine();
+
+
 /**
  * @brief   class constructor
  *
@@ -69,16 +110,9 @@ CRC16::CRC16( uint16_t initValue )
  */
 
 uint16_t
-CRC16::Calc( const ByteArray &data ) {
+CRC16::Calc( const ByteArrayView &data ) {
 
-    uint16_t bcount = data.count();
-    uint16_t index  = 0;
-
-    // iterate over all bytes
-    while ( index < bcount ) {
-        // calc new crc
-        _CRC = ( _CRC >> 8 ) ^ _Table[ ( _CRC ^ data.at( index++ ) ) & 0x00FF ];
-    }
+    _CRC = Update( _CRC, data.data(), data.count() );
 
     // return result
     return _CRC;
@@ -93,7 +127,7 @@ CRC16::Calc( const ByteArray &data ) {
  */
 
 uint16_t
-CRC16::Calc_X25( const ByteArray &data ) {
+CRC16::Calc_X25( const ByteArrayView &data ) {
     // CRC init value must be 0xFFFF, see constructor
     // return 1's complement of crc16
     return ~Calc( data );
@@ -108,7 +142,7 @@ CRC16::Calc_X25( const ByteArray &data ) {
  */
 
 bool
-CRC16::Check_X25( const ByteArray &data ) {
+CRC16::Check_X25( const ByteArrayView &data ) {
 
     // get 1's compelemnt
     uint16_t crc = Calc_X25( data );
@@ -116,3 +150,279 @@ CRC16::Check_X25( const ByteArray &data ) {
     // compare it with constant good value
     return (bool) ( crc == CRC16::Good_Value );
 }
+
+/**
+ * @brief   continue a raw CRC16 calculation with the selected engine
+ *
+ * @param   crc     current crc value
+ * @param   data    input data
+ * @param   n       number of bytes
+ *
+ * @return  updated crc
+ */
+
+uint16_t
+CRC16::Update( uint16_t crc, const uint8_t* data, uint32_t n ) {
+    switch ( _Engine ) {
+#if 0 != _CRC16_CLMUL_
+        case Engine_CLMul:
+            return updateCLMul( crc, data, n );
+#endif
+#if 8 == _CRC16_SLICE_BY_
+        case Engine_Slice8:
+            return updateSlice8( crc, data, n );
+#endif
+#if 0 != _CRC16_SLICE_BY_
+        case Engine_Slice4:
+            return updateSlice4( crc, data, n );
+#endif
+        default:
+            return updateTable( crc, data, n );
+    }
+}
+
+/**
+ * @brief   select calculation engine at run time
+ *
+ * @param   engine  engine to use
+ *
+ * @return  true  - engine selected
+ *          false - engine not compiled in or not supported by CPU
+ */
+
+bool
+CRC16::SetEngine( Engine engine ) {
+    if ( !IsAvailable( engine ) ) {
+        return false;
+    }
+    _Engine = engine;
+    return true;
+}
+
+/**
+ * @return  selected calculation engine
+ */
+
+CRC16::Engine
+CRC16::GetEngine( void ) {
+    return _Engine;
+}
+
+/**
+ * @return  true if engine is compiled in and supported by CPU
+ */
+
+bool
+CRC16::IsAvailable( Engine engine ) {
+    switch ( engine ) {
+        case Engine_Table:
+            return true;
+        case Engine_Slice4:
+            return ( 4 <= _CRC16_SLICE_BY_ );
+        case Engine_Slice8:
+            return ( 8 <= _CRC16_SLICE_BY_ );
+        case Engine_CLMul:
+#if 0 != _CRC16_CLMUL_
+            // may run from a static constructor, before the CPU model is initialised
+            __builtin_cpu_init();
+            return __builtin_cpu_supports( "pclmul" );
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * @return  engine name
+ */
+
+const char*
+CRC16::EngineName( Engine engine ) {
+    switch ( engine ) {
+        case Engine_Table:  return "table";
+        case Engine_Slice4: return "slice-by-4";
+        case Engine_Slice8: return "slice-by-8";
+        case Engine_CLMul:  return "clmul";
+        default:            return "unknown";
+    }
+}
+
+/**
+ * @brief   fastest engine available at start-up
+ */
+
+CRC16::Engine
+CRC16::bestEngine( void ) {
+    for ( int engine = Engines - 1; engine > Engine_Table; engine-- ) {
+        if ( IsAvailable( (Engine)engine ) ) {
+            return (Engine)engine;
+        }
+    }
+    return Engine_Table;
+}
+
+/**
+ * @brief   table engine, one byte per step
+ */
+
+uint16_t
+CRC16::updateTable( uint16_t crc, const uint8_t* data, uint32_t n ) {
+
+    const uint8_t*  pdata   = data;
+    const uint8_t*  plimit  = pdata + n;
+
+    // iterate over all bytes
+    while ( pdata < plimit ) {
+        // calc new crc
+        crc = ( crc >> 8 ) ^ _Table[ ( crc ^ *pdata++ ) & 0x00FF ];
+    }
+    return crc;
+}
+
+/**
+ * @brief   slice-by-4 engine, four independent table lookups per step
+ */
+
+uint16_t
+CRC16::updateSlice4( uint16_t crc, const uint8_t* data, uint32_t n ) {
+#if 0 != _CRC16_SLICE_BY_
+    const uint8_t*  pdata   = data;
+
+    while ( n >= 4 ) {
+        crc = _Slices.Slice[2][ (uint8_t)( crc ^ pdata[0] ) ]
+            ^ _Slices.Slice[1][ (uint8_t)( ( crc >> 8 ) ^ pdata[1] ) ]
+            ^ _Slices.Slice[0][ pdata[2] ]
+            ^ _Table[ pdata[3] ];
+        pdata += 4;
+        n -= 4;
+    }
+    return updateTable( crc, pdata, n );
+#else
+    return updateTable( crc, data, n );
+#endif
+}
+
+/**
+ * @brief   slice-by-8 engine, eight independent table lookups per step
+ */
+
+uint16_t
+CRC16::updateSlice8( uint16_t crc, const uint8_t* data, uint32_t n ) {
+#if 8 == _CRC16_SLICE_BY_
+    const uint8_t*  pdata   = data;
+
+    while ( n >= 8 ) {
+        crc = _Slices.Slice[6][ (uint8_t)( crc ^ pdata[0] ) ]
+            ^ _Slices.Slice[5][ (uint8_t)( ( crc >> 8 ) ^ pdata[1] ) ]
+            ^ _Slices.Slice[4][ pdata[2] ]
+            ^ _Slices.Slice[3][ pdata[3] ]
+            ^ _Slices.Slice[2][ pdata[4] ]
+            ^ _Slices.Slice[1][ pdata[5] ]
+            ^ _Slices.Slice[0][ pdata[6] ]
+            ^ _Table[ pdata[7] ];
+        pdata += 8;
+        n -= 8;
+    }
+    return updateSlice4( crc, pdata, n );
+#else
+    return updateSlice4( crc, data, n );
+#endif
+}
+
+#if 0 != _CRC16_CLMUL_
+
+/**
+ * @brief   returns folding constant x^(n-1) mod P, bit reflected into 64 bits
+ *          (P = x^16 + x^12 + x^5 + 1, the reflected carry-less product gains one x)
+ */
+static constexpr uint64_t
+clmulConstant( uint32_t n ) {
+    uint32_t r = 1;
+    for ( uint32_t i = 1; i < n; i++ ) {
+        r <<= 1;
+        if ( r & 0x10000 ) {
+            r ^= 0x11021;
+        }
+    }
+    uint64_t k = 0;
+    for ( int d = 0; d < 16; d++ ) {
+        if ( ( r >> d ) & 1 ) {
+            k |= 1ull << ( 63 - d );
+        }
+    }
+    return k;
+}
+
+//<! folding constants for 128 and 512 bit distances
+static constexpr uint64_t   _K128   =   clmulConstant( 128 );
+static constexpr uint64_t   _K192   =   clmulConstant( 192 );
+static constexpr uint64_t   _K512   =   clmulConstant( 512 );
+static constexpr uint64_t   _K576   =   clmulConstant( 576 );
+
+/**
+ * @brief   folds a 128 bit block forward, constants in k: low - x^(d+64), high - x^d
+ */
+__attribute__(( target( "pclmul,sse2" ) ))
+static inline __m128i
+clmulFold( __m128i x, __m128i k ) {
+    return _mm_xor_si128( _mm_clmulepi64_si128( x, k, 0x00 ), _mm_clmulepi64_si128( x, k, 0x11 ) );
+}
+
+#endif
+
+/**
+ * @brief   carry-less multiply engine, folds 4 x 16 bytes per step,
+ *          the last 16 bytes of the folded state and the tail go through slicing
+ */
+
+#if 0 != _CRC16_CLMUL_
+__attribute__(( target( "pclmul,sse2" ) ))
+#endif
+uint16_t
+CRC16::updateCLMul( uint16_t crc, const uint8_t* data, uint32_t n ) {
+#if 0 != _CRC16_CLMUL_
+    if ( n < 64 ) {
+        return updateSlice8( crc, data, n );
+    }
+
+    const __m128i k128 = _mm_set_epi64x( (long long)_K128, (long long)_K192 );
+    const __m128i k512 = _mm_set_epi64x( (long long)_K512, (long long)_K576 );
+
+    const uint8_t*  pdata   = data;
+    __m128i x0 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*)( pdata      ) ), _mm_cvtsi32_si128( crc ) );
+    __m128i x1 = _mm_loadu_si128( (const __m128i*)( pdata + 16 ) );
+    __m128i x2 = _mm_loadu_si128( (const __m128i*)( pdata + 32 ) );
+    __m128i x3 = _mm_loadu_si128( (const __m128i*)( pdata + 48 ) );
+    pdata += 64;
+    n -= 64;
+
+    while ( n >= 64 ) {
+        x0 = _mm_xor_si128( clmulFold( x0, k512 ), _mm_loadu_si128( (const __m128i*)( pdata      ) ) );
+        x1 = _mm_xor_si128( clmulFold( x1, k512 ), _mm_loadu_si128( (const __m128i*)( pdata + 16 ) ) );
+        x2 = _mm_xor_si128( clmulFold( x2, k512 ), _mm_loadu_si128( (const __m128i*)( pdata + 32 ) ) );
+        x3 = _mm_xor_si128( clmulFold( x3, k512 ), _mm_loadu_si128( (const __m128i*)( pdata + 48 ) ) );
+        pdata += 64;
+        n -= 64;
+    }
+
+    x1 = _mm_xor_si128( clmulFold( x0, k128 ), x1 );
+    x2 = _mm_xor_si128( clmulFold( x1, k128 ), x2 );
+    x0 = _mm_xor_si128( clmulFold( x2, k128 ), x3 );
+
+    while ( n >= 16 ) {
+        x0 = _mm_xor_si128( clmulFold( x0, k128 ), _mm_loadu_si128( (const __m128i*)pdata ) );
+        pdata += 16;
+        n -= 16;
+    }
+
+    // folded state is congruent to the data so far, finish with slicing
+    uint8_t folded[16];
+    _mm_storeu_si128( (__m128i*)folded, x0 );
+    crc = updateSlice8( 0, folded, sizeof( folded ) );
+    return updateSlice8( crc, pdata, n );
+#else
+    return updateSlice8( crc, data, n );
+#endif
+}
@@ -16,11 +16,24 @@
 #define _CRC16_H_
 
 #include <stdint.h>
-#include "ByteArray.h"
+#include "ByteArrayView.h"
+
+
+//<! slicing tables in flash: 0 - single table, 4 - slice-by-4 (+1.5 KB), 8 - slice-by-8 (+3.5 KB)
+#define _CRC16_SLICE_BY_    8
+
+#if !defined( ARDUINO ) && ( defined( __x86_64__ ) || defined( __i386__ ) ) && defined( __GNUC__ )
+//<! carry-less multiply engine for x86 host builds, used if the CPU supports PCLMULQDQ
+#define _CRC16_CLMUL_       1
+#else
+#define _CRC16_CLMUL_       0
+#endif
+
 
 /**
  * @brief   The CRC16 class provides methods for CRC calculation and checking. The implemented CRC uses the well known
  *          16 Bit CCITT Polynom. For performance reason a lookup-table is used which was generated by means of this polynom.
+ *          Slicing tables and a carry-less multiply engine can be selected at compile time and at run time.
  */
 
 class CRC16 {
@@ -33,6 +46,15 @@ class CRC16 {
             Polynom     =  0x8408     //!< 16 Bit CRC CCITT Generator Polynom, used for table generation
         };
 
+        //<! calculation engines
+        enum Engine : uint8_t {
+            Engine_Table    =   0,      //!< 256-entry table, byte at a time
+            Engine_Slice4,              //!< slice-by-4 tables, 4 bytes at a time
+            Engine_Slice8,              //!< slice-by-8 tables, 8 bytes at a time
+            Engine_CLMul,               //!< PCLMULQDQ folding, 64 bytes at a time, x86 host only
+            Engines
+        };
+
         /**
           * @brief  class constructor
           *
@@ -47,7 +69,7 @@ class CRC16 {
          *
          * @return  crc16
          */
-        uint16_t    Calc( const ByteArray &data );
+        uint16_t    Calc( const ByteArrayView &data );
 
         /**
          * @brief   calculate CRC16 according to X25 recommandation
@@ -56,7 +78,7 @@ class CRC16 {
          *
          * @return  1's complement of crc16
          */
-        uint16_t    Calc_X25( const ByteArray &data );
+        uint16_t    Calc_X25( const ByteArrayView &data );
 
         /**
          * @brief   calculate and check CRC16
@@ -66,7 +88,44 @@ class CRC16 {
          * @return  true  - CRC16 ok
          *          false - CRC16 error
          */
-        bool        Check_X25( const ByteArray &data );
+        bool        Check_X25( const ByteArrayView &data );
+
+        /**
+         * @brief   continue a raw CRC16 calculation over a block of bytes
+         *          with the selected engine
+         *
+         * @param   crc     current crc value
+         * @param   data    input data
+         * @param   n       number of bytes
+         *
+         * @return  updated crc
+         */
+        static uint16_t Update( uint16_t crc, const uint8_t* data, uint32_t n );
+
+        /**
+         * @brief   select calculation engine at run time
+         *
+         * @param   engine  engine to use
+         *
+         * @return  true  - engine selected
+         *          false - engine not compiled in or not supported by CPU
+         */
+        static bool     SetEngine( Engine engine );
+
+        /**
+         * @return  selected calculation engine
+         */
+        static Engine   GetEngine( void );
+
+        /**
+         * @return  true if engine is compiled in and supported by CPU
+         */
+        static bool     IsAvailable( Engine engine );
+
+        /**
+         * @return  engine name
+         */
+        static const char*  EngineName( Engine engine );
 
     private:
 
@@ -76,6 +135,18 @@ class CRC16 {
         //<! static lookup table for fast calculation
         static const uint16_t   _Table[];
 
+        //<! selected calculation engine
+        static Engine           _Engine;
+
+        //<! engines, see CRC16.cpp
+        static uint16_t         updateTable( uint16_t crc, const uint8_t* data, uint32_t n );
+        static uint16_t         updateSlice4( uint16_t crc, const uint8_t* data, uint32_t n );
+        static uint16_t         updateSlice8( uint16_t crc, const uint8_t* data, uint32_t n );
+        static uint16_t         updateCLMul( uint16_t crc, const uint8_t* data, uint32_t n );
+
+        //<! fastest engine available at start-up
+        static Engine           bestEngine( void );
+
 };
 
 #endif // _CRC16_H_
@@ -74,3 +74,19 @@ void        addCurrentTimeInUSeconds( uint32_t USeconds ) {
 }
 
 #endif
+
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+uint32_t    getTimeInMs( void ) {
+#ifdef ARDUINO
+    return millis();
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
+#endif
+}
@@ -34,4 +34,7 @@ void        addCurrentTimeInUSeconds( uint32_t USeconds );
 
 #endif
 
+//monotonic time stamp in ms, wraps after 49 days
+uint32_t    getTimeInMs( void );
+
 #endif // _CURRENTTIME_H_
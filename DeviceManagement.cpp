@@ -12,14 +12,15 @@
 #include "DeviceManagement.h"
 #include <string>
 #include <cstring>  //strstr
+#include <stdio.h>  //snprintf
 
 //#include <QDateTime>
 #include "CurrentTime.h"
 
 
-//<! map with status code strings
+//<! table with status code strings, built by the compiler
 //const aMap < uint8_t, std::string > DeviceManagement::_StatusCodes = {
-const aMap < uint8_t, const char* > DeviceManagement::_StatusCodes = {
+constexpr aDenseMap < const char*, DeviceManagement::CommandRejected + 1 > DeviceManagement::_StatusCodes = {{
     { Ok,                       "ok" },
     { Error,                    "error" },
     { CommandNotSupported,      "command not supported" },
@@ -31,20 +32,20 @@ const aMap < uint8_t, const char* > DeviceManagement::_StatusCodes = {
     { NVM_WriteError,           "NVM write error" },
     { NVM_ReadError,            "NVM read error" },
     { CommandRejected,          "command rejected" }
-};
+}};
 
-//<! map with module type strings
+//<! table with module type strings, built by the compiler
 //const aMap < uint8_t, std::string > DeviceManagement::_ModuleTypes = {
-const aMap < uint8_t, const char* > DeviceManagement::_ModuleTypes = {
+constexpr aSortedMap < uint8_t, const char*, 4 > DeviceManagement::_ModuleTypes = {{
     { 104,  "iM284A-XL" },
     { 109,  "iM891A-XL" },
     { 110,  "iU891A-XL" },
     { 163,  "iM881A-XL" }
-};
+}};
 
-//<! map with response & event names for HCI messages
+//<! table with response & event names for HCI messages, built by the compiler
 //const aMap < uint8_t, std::string > DeviceManagement::_EventNames = {
-const aMap < uint8_t, const char* > DeviceManagement::_EventNames = {
+constexpr aSortedMap < uint8_t, const char*, 9 > DeviceManagement::_EventNames = {{
     { Startup_Ind,              "startup indication" },
     { Ping_Rsp,                 "ping device response" },
     { GetDeviceInfo_Rsp,        "get device info response" },
@@ -54,10 +55,10 @@ const aMap < uint8_t, const char* > DeviceManagement::_EventNames = {
     { RestartDevice_Rsp,        "restart device response" },
     { SetSystemOptions_Rsp,     "set system options response" },
     { GetSystemOptions_Rsp,     "get system options response" }
-};
+}};
 
-//<! map with message handlers for HCI messages
-const aMap < uint8_t , DeviceManagement::Handler > DeviceManagement::_Handlers = {
+//<! table with message handlers for HCI messages, built by the compiler
+constexpr aSortedMap < uint8_t , DeviceManagement::Handler, 9 > DeviceManagement::_Handlers = {{
     { Startup_Ind,              &DeviceManagement::OnStartupIndication },
     { Ping_Rsp,                 &DeviceManagement::OnDefaultResponse },
     { GetDeviceInfo_Rsp,        &DeviceManagement::OnDeviceInfoResponse },
@@ -67,59 +68,77 @@ const aMap < uint8_t , DeviceManagement::Handler > DeviceManagement::_Handlers =
     { RestartDevice_Rsp,        &DeviceManagement::OnDefaultResponse },
     { SetSystemOptions_Rsp,     &DeviceManagement::OnDefaultResponse },
     { GetSystemOptions_Rsp,     &DeviceManagement::OnSystemOptionsResponse }
-};
+}};
 
 /**
  * @brief   class constructor
  *
- * @param   port        a serial port
+ * @param   tx          transmit engine of the radio serial port
+ *
+ * @param   requests    outstanding requests of the radio stack
  */
-DeviceManagement::DeviceManagement( HardwareSerial& port )
-                : ServiceAccessPoint( DeviceManagement::Sap_ID, port ) {
+DeviceManagement::DeviceManagement( UartTx& tx, RequestTracker& requests )
+                : ServiceAccessPoint( DeviceManagement::Sap_ID, tx, requests )
+                , _Client           ( nullptr ) {
 }
 
 
 /**
  * @brief   send "ping request"
+ *
+ * @param   client      receiver of response or timeout, optional
  */
 bool
-DeviceManagement::OnPingDevice() {
-    return SendMessage( Ping_Req );
+DeviceManagement::OnPingDevice( RequestTracker::Client* client ) {
+    SerialMessage msg( DeviceManagement::Sap_ID, Ping_Req );
+
+    //liveness check, ahead of bulk data
+    msg.SetPriority( SerialMessage::Priority_Control );
+
+    return SendRequest( msg, Ping_Rsp, client );
 }
 
 
 /**
  * @brief   send "get device information request"
+ *
+ * @param   client      receiver of response or timeout, optional
  */
 bool
-DeviceManagement::OnGetDeviceInfo() {
-    return SendMessage( GetDeviceInfo_Req );
+DeviceManagement::OnGetDeviceInfo( RequestTracker::Client* client ) {
+    return SendRequest( GetDeviceInfo_Req, GetDeviceInfo_Rsp, client );
 }
 
 
 /**
  * @brief   send "get firmware version request"
+ *
+ * @param   client      receiver of response or timeout, optional
  */
 bool
-DeviceManagement::OnGetFirmwareVersion() {
-    return SendMessage( GetFirmwareVersion_Req );
+DeviceManagement::OnGetFirmwareVersion( RequestTracker::Client* client ) {
+    return SendRequest( GetFirmwareVersion_Req, GetFirmwareVersion_Rsp, client );
 }
 
 
 /**
  * @brief   send "get date time request"
+ *
+ * @param   client      receiver of response or timeout, optional
  */
 bool
-DeviceManagement::OnGetDateTime() {
-    return SendMessage( GetDateTime_Req );
+DeviceManagement::OnGetDateTime( RequestTracker::Client* client ) {
+    return SendRequest( GetDateTime_Req, GetDateTime_Rsp, client );
 }
 
 
 /**
  * @brief   send "set date time request"
+ *
+ * @param   client      receiver of response or timeout, optional
  */
 bool
-DeviceManagement::OnSetDateTime() {
+DeviceManagement::OnSetDateTime( RequestTracker::Client* client ) {
     SerialMessage msg( DeviceManagement::Sap_ID, SetDateTime_Req );
 
     //uint32_t  secondsSincePeriod = QDateTime::currentSecsSinceEpoch();
@@ -127,33 +146,42 @@ DeviceManagement::OnSetDateTime() {
 
     msg.Append( secondsSincePeriod );
 
-    return SendMessage( msg );
+    //the time stamp ages while queued
+    msg.SetPriority( SerialMessage::Priority_Control );
+
+    return SendRequest( msg, SetDateTime_Rsp, client );
 }
 
 
 /**
  * @brief   send "restart device request"
+ *
+ * @param   client      receiver of response or timeout, optional
  */
 bool
-DeviceManagement::OnRestartDevice() {
-    return SendMessage( RestartDevice_Req );
+DeviceManagement::OnRestartDevice( RequestTracker::Client* client ) {
+    return SendRequest( RestartDevice_Req, RestartDevice_Rsp, client );
 }
 
 
 /**
  * @brief   send "get system options request"
+ *
+ * @param   client      receiver of response or timeout, optional
  */
 bool
-DeviceManagement::OnGetSystemOptions() {
-    return SendMessage( GetSystemOptions_Req );
+DeviceManagement::OnGetSystemOptions( RequestTracker::Client* client ) {
+    return SendRequest( GetSystemOptions_Req, GetSystemOptions_Rsp, client );
 }
 
 
 /**
  * @brief   send "set system options request"
+ *
+ * @param   client      receiver of response or timeout, optional
  */
 bool
-DeviceManagement::OnSetSystemOptions( const Dictionary& params ) {
+DeviceManagement::OnSetSystemOptions( const Dictionary& params, RequestTracker::Client* client ) {
 
     SerialMessage msg( DeviceManagement::Sap_ID, SetSystemOptions_Req );
 
@@ -167,7 +195,9 @@ DeviceManagement::OnSetSystemOptions( const Dictionary& params ) {
     static const char* Start_on     = "Startup Event = on";
     static const char* Start_off    = "Startup Event = off";
 
-    if ( ( data = (char*)params.contains("Options") ) ) {
+    static constexpr Dictionary::Key Options( "Options" );
+
+    if ( ( data = (char*)params.contains( Options ) ) ) {
         if ( strstr( data, Trace_on ) ) {
 
             mask    |= SO_Trace;
@@ -193,22 +223,23 @@ DeviceManagement::OnSetSystemOptions( const Dictionary& params ) {
     msg.Append( mask );
     msg.Append( options );
 
-    return SendMessage( msg );
+    return SendRequest( msg, SetSystemOptions_Rsp, client );
 
 }
 
 
 /**
- * @brief   find message handler and decode convert message into json format
+ * @brief   find message handler and decode message, typed to the client,
+ *          as text into result if a text consumer is attached
  *
  * @param   serialMsg       incoming HCI message
  *
- * @param   result          decoded data in Json format
+ * @param   result          decoded data in Json format, nullptr for no text
  *
  * @return  true/false
  */
 bool
-DeviceManagement::OnDecodeMessage( const SerialMessage& serialMsg, Dictionary& result ) {
+DeviceManagement::OnDecodeMessage( const SerialMessage& serialMsg, Dictionary* result ) {
 
     uint8_t msgID = serialMsg.GetMsgID();
 
@@ -216,16 +247,19 @@ DeviceManagement::OnDecodeMessage( const SerialMessage& serialMsg, Dictionary& r
     Handler handler = _Handlers.value( msgID, nullptr );
     if ( handler != nullptr ) {
         //get handler event name
-        result.append("Event",
-            _EventNames.value( msgID, "unknown handler name" ) );
+        if ( result ) {
+            result->append("Event",
+                _EventNames.value( msgID, "unknown handler name" ) );
+        }
         //call message handler
         return ( this->*handler )( serialMsg, result );
     }
     //no handler found
-    
-    result.append  ("Error", "unsupported MsgID: ");
-    result.appendU8( msgID );
-    result.append  (" received");
+
+    if ( result ) {
+        result->append("Error", "unsupported MsgID received");
+        result->append("MsgID", msgID );
+    }
     return true;
 }
 
@@ -235,19 +269,25 @@ DeviceManagement::OnDecodeMessage( const SerialMessage& serialMsg, Dictionary& r
  *
  * @param   serialMsg       incoming HCI message
  *
- * @param   result          decoded data in Json format
+ * @param   result          decoded data in Json format, nullptr for no text
  *
  * @return  true/false
  */
 bool
-DeviceManagement::OnDefaultResponse( const SerialMessage& serialMsg, Dictionary& result ) {
+DeviceManagement::OnDefaultResponse( const SerialMessage& serialMsg, Dictionary* result ) {
     // check minimum payload length
-    if ( serialMsg.GetPayloadLength() >= 1 ) {
-        result.append("Status",
-            _StatusCodes.value( serialMsg.GetResponseStatus(), "error" ) );
-        return true;
+    if ( serialMsg.GetPayloadLength() < 1 )
+        return false;
+
+    uint8_t status = serialMsg.GetResponseStatus();
+    if ( _Client ) {
+        _Client->OnDeviceManagement_Status( serialMsg.GetMsgID(), status );
     }
-    return false;
+    if ( result ) {
+        result->append("Status",
+            _StatusCodes.value( status, "error" ) );
+    }
+    return true;
 }
 
 /**
@@ -255,25 +295,30 @@ DeviceManagement::OnDefaultResponse( const SerialMessage& serialMsg, Dictionary&
  *
  * @param   serialMsg       incoming HCI message
  *
- * @param   result          decoded data in Json format
+ * @param   result          decoded data in Json format, nullptr for no text
  *
  * @return  true/false
  */
 bool
-DeviceManagement::OnStartupIndication( const SerialMessage& serialMsg, Dictionary& result ) {
+DeviceManagement::OnStartupIndication( const SerialMessage& serialMsg, Dictionary* result ) {
     // check minimum payload length
     if ( serialMsg.GetPayloadLength() < ( ReservedInfo_Size + DeviceInfo_Size + FirmwareInfo_MinSize ) )
         return false;
 
+    int             index       =   SerialMessage::EventData_Index + ReservedInfo_Size;
+    FirmwareInfo    firmware    =   ParseFirmwareInfo( serialMsg, index + DeviceInfo_Size );
+
+    if ( _Client ) {
+        _Client->OnDeviceManagement_Startup( ParseDeviceInfo( serialMsg, index ), firmware );
+    }
+    if ( result ) {
 #if ReservedInfo_Size > 0
-    result.append("Reserved Info",
-        serialMsg.GetHexString( SerialMessage::EventData_Index, ReservedInfo_Size ) );
+        result->appendBytes("Reserved Info",
+            serialMsg.GetPayload( SerialMessage::EventData_Index, ReservedInfo_Size ) );
 #endif
-    result.append("Device Info",
-        DecodeDeviceInfo( serialMsg, SerialMessage::EventData_Index + ReservedInfo_Size ) );
-    result.append("Firmware Info",
-        DecodeFirmwareInfo( serialMsg, SerialMessage::EventData_Index + ReservedInfo_Size + DeviceInfo_Size ) );
-
+        DecodeDeviceInfo( serialMsg, index, result );
+        DecodeFirmwareInfo( firmware, result );
+    }
     return true;
 }
 
@@ -283,22 +328,31 @@ DeviceManagement::OnStartupIndication( const SerialMessage& serialMsg, Dictionar
  *
  * @param   serialMsg       incoming HCI message
  *
- * @param   result          decoded data in Json format
+ * @param   result          decoded data in Json format, nullptr for no text
  *
  * @return  true/false
  */
 bool
-DeviceManagement::OnDeviceInfoResponse( const SerialMessage& serialMsg, Dictionary& result ) {
+DeviceManagement::OnDeviceInfoResponse( const SerialMessage& serialMsg, Dictionary* result ) {
     // check minimum response payload length
     if ( serialMsg.GetResponsePayloadLength() < DeviceInfo_Size )
         return false;
 
     uint8_t status = serialMsg.GetResponseStatus();
-    result.append("Status", _StatusCodes.value( status, "error" ) );
 
-    if ( Ok == status ) {
-        result.append("Device Info",
-            DecodeDeviceInfo( serialMsg, SerialMessage::ResponseData_Index ) );
+    if ( _Client ) {
+        DeviceInfo info = {};
+        if ( Ok == status ) {
+            info = ParseDeviceInfo( serialMsg, SerialMessage::ResponseData_Index );
+        }
+        _Client->OnDeviceManagement_DeviceInfo( status, info );
+    }
+    if ( result ) {
+        result->append("Status", _StatusCodes.value( status, "error" ) );
+
+        if ( Ok == status ) {
+            DecodeDeviceInfo( serialMsg, SerialMessage::ResponseData_Index, result );
+        }
     }
     return true;
 }
@@ -310,47 +364,76 @@ DeviceManagement::OnDeviceInfoResponse( const SerialMessage& serialMsg, Dictiona
  * @param   serialMsg       incoming HCI message
  * @param   index           index to device info field
  *
- * @return  Dictionary including decoded data
+ * @return  decoded Device Info
  */
-Dictionary
-DeviceManagement::DecodeDeviceInfo( const SerialMessage& serialMsg, int index ) const {
-    Dictionary info;
-    uint8_t moduleType      =   serialMsg.GetU8( index );
-    //info.append("Module Type",
-    //    _ModuleTypes.value( moduleType, "unknown module type:" + std::to_string( moduleType ) ) );
-    info.append("Module Type",
-        _ModuleTypes.value( moduleType, "unknown module type: " ) );
-    info.appendU8( moduleType );
-    //info.append("Module ID",    std::to_string( serialMsg.GetU32( index + 1 ) ) );
-    info.append("Module ID",    serialMsg.GetU32( index + 1 ) );
-    info.append("Product Type", serialMsg.GetHexString( index + 5, 4 ) );
-    info.append("Product ID",   serialMsg.GetHexString( index + 9, 4 ) );
-
+DeviceManagement::DeviceInfo
+DeviceManagement::ParseDeviceInfo( const SerialMessage& serialMsg, int index ) const {
+    DeviceInfo info;
+    info.ModuleType     =   serialMsg.GetU8( index );
+    info.ModuleID       =   serialMsg.GetU32( index + 1 );
+    info.ProductType    =   serialMsg.GetU32( index + 5 );
+    info.ProductID      =   serialMsg.GetU32( index + 9 );
     return info;
 }
 
 
+/**
+ * @brief   format Device Info Field as Object "Device Info", in place
+ *
+ * @param   serialMsg       incoming HCI message
+ * @param   index           index to device info field
+ * @param   result          decoded data
+ *
+ * @return  -
+ */
+void
+DeviceManagement::DecodeDeviceInfo( const SerialMessage& serialMsg, int index, Dictionary* result ) const {
+    uint8_t     moduleType  =   serialMsg.GetU8( index );
+    const char* moduleName  =   _ModuleTypes.value( moduleType, nullptr );
+    result->beginObject("Device Info");
+    //unknown module types as number
+    if ( moduleName ) {
+        result->append("Module Type",   moduleName );
+    } else {
+        result->append("Module Type",   moduleType );
+    }
+    result->append("Module ID",         serialMsg.GetU32( index + 1 ) );
+    result->appendBytes("Product Type", serialMsg.GetPayload( index + 5, 4 ) );
+    result->appendBytes("Product ID",   serialMsg.GetPayload( index + 9, 4 ) );
+    result->close();
+}
+
+
 /**
  * @brief   decode get firmware version response
  *
  * @param   serialMsg       incoming HCI message
  *
- * @param   result          decoded data in Json format
+ * @param   result          decoded data in Json format, nullptr for no text
  *
  * @return  true/false
  */
 bool
-DeviceManagement::OnFirmwareVersionResponse( const SerialMessage& serialMsg, Dictionary& result ) {
+DeviceManagement::OnFirmwareVersionResponse( const SerialMessage& serialMsg, Dictionary* result ) {
     // check minimum payload length
     if ( serialMsg.GetResponsePayloadLength() < FirmwareInfo_MinSize )
         return false;
 
-    uint8_t status                  =   serialMsg.GetResponseStatus();
-    result.append("Status", _StatusCodes.value( status, "error" ) );
-
+    uint8_t         status      =   serialMsg.GetResponseStatus();
+    FirmwareInfo    firmware    =   {};
     if ( Ok == status ) {
-        result.append("Firmware Info",
-            DecodeFirmwareInfo( serialMsg, SerialMessage::ResponseData_Index ) );
+        firmware = ParseFirmwareInfo( serialMsg, SerialMessage::ResponseData_Index );
+    }
+
+    if ( _Client ) {
+        _Client->OnDeviceManagement_FirmwareInfo( status, firmware );
+    }
+    if ( result ) {
+        result->append("Status", _StatusCodes.value( status, "error" ) );
+
+        if ( Ok == status ) {
+            DecodeFirmwareInfo( firmware, result );
+        }
     }
     return true;
 }
@@ -362,22 +445,48 @@ DeviceManagement::OnFirmwareVersionResponse( const SerialMessage& serialMsg, Dic
  * @param   serialMsg       incoming HCI message
  * @param   index           index to firmware info field
  *
- * @return  Dictionary including decoded data
+ * @return  decoded Firmware Info, views into serialMsg
  */
-Dictionary
-DeviceManagement::DecodeFirmwareInfo( const SerialMessage& serialMsg, int index ) const {
-    Dictionary info;
-    info.append("Version",
-        std::to_string( serialMsg.GetU8( index + 1 ) ) + 
-            "." + std::to_string( serialMsg.GetU8( index ) ) );
-    info.append("Build Count",
-        std::to_string( serialMsg.GetU16( index + 2 ) ) );
-    info.append("Build Date", 
-        serialMsg.GetData( index + 4 ), 10 );
-    info.append("Firmware Name",
-        serialMsg.GetData( index + 14 ) );
+DeviceManagement::FirmwareInfo
+DeviceManagement::ParseFirmwareInfo( const SerialMessage& serialMsg, int index ) const {
+    FirmwareInfo firmware;
+    firmware.MinorVersion   =   serialMsg.GetU8( index );
+    firmware.MajorVersion   =   serialMsg.GetU8( index + 1 );
+    firmware.BuildCount     =   serialMsg.GetU16( index + 2 );
+    firmware.BuildDate      =   ByteArrayView( serialMsg.GetData( index + 4 ), 10 );
+
+    //name up to its NUL or the end of the message
+    const uint8_t*  name    =   serialMsg.GetData( index + 14 );
+    int             size    =   serialMsg.count() - ( index + 14 );
+    const void*     end     =   ( name && ( 0 < size ) ) ? memchr( name, 0, size ) : nullptr;
+    if ( end ) {
+        size = (int)( (const uint8_t*)end - name );
+    }
+    firmware.Name           =   ByteArrayView( name, ( 0 < size ) ? (uint16_t)size : 0 );
+    return firmware;
+}
 
-    return info;
+
+/**
+ * @brief   format Firmware Info Field as Object "Firmware Info", in place
+ *
+ * @param   firmware        decoded Firmware Info
+ * @param   result          decoded data
+ *
+ * @return  -
+ */
+void
+DeviceManagement::DecodeFirmwareInfo( const FirmwareInfo& firmware, Dictionary* result ) const {
+    char version[8];
+    snprintf( version, sizeof( version ), "%u.%u", firmware.MajorVersion, firmware.MinorVersion );
+    result->beginObject("Firmware Info");
+    result->append("Version",       (const char*)version );
+    result->append("Build Count",   firmware.BuildCount );
+    result->append("Build Date",
+        firmware.BuildDate.data(), firmware.BuildDate.count() );
+    result->append("Firmware Name",
+        firmware.Name.data(), firmware.Name.count() );
+    result->close();
 }
 
 
@@ -386,30 +495,36 @@ DeviceManagement::DecodeFirmwareInfo( const SerialMessage& serialMsg, int index
  *
  * @param   serialMsg       incoming HCI message
  *
- * @param   result          decoded data in Json format
+ * @param   result          decoded data in Json format, nullptr for no text
  *
  * @return  true/false
  */
 bool
-DeviceManagement::OnDateTimeResponse( const SerialMessage& serialMsg, Dictionary& result ) {
+DeviceManagement::OnDateTimeResponse( const SerialMessage& serialMsg, Dictionary* result ) {
     // check minimum payload length
     if ( serialMsg.GetResponsePayloadLength() < ( 4 ) )
         return false;
 
-    uint8_t status                      =   serialMsg.GetResponseStatus();
-    result.append("Status",             _StatusCodes.value( status, "error" ) );
-
+    uint8_t         status              =   serialMsg.GetResponseStatus();
+    DateTimeInfo    info                =   {};
     if ( Ok == status ) {
-        //Dictionary info;
-        
-        result.append(
-            "Date Time Info.Seconds since epoch",
-            std::to_string( serialMsg.GetU32( SerialMessage::ResponseData_Index ) ) );
-        result.append(
-            "Date Time Info.Date Time",
-            serialMsg.GetDateTime( SerialMessage::ResponseData_Index, "dd-MM-yyyy hh:mm:ss" ) );
-        //result[ "Date Time Info" ]      =   info;
+        info.Seconds                    =   serialMsg.GetU32( SerialMessage::ResponseData_Index );
+    }
 
+    if ( _Client ) {
+        _Client->OnDeviceManagement_DateTime( status, info );
+    }
+    if ( result ) {
+        result->append("Status",        _StatusCodes.value( status, "error" ) );
+
+        if ( Ok == status ) {
+            result->beginObject("Date Time Info");
+            result->append("Seconds since epoch",
+                info.Seconds );
+            result->append("Date Time",
+                serialMsg.GetDateTime( SerialMessage::ResponseData_Index, "dd-MM-yyyy hh:mm:ss" ) );
+            result->close();
+        }
     }
     return true;
 }
@@ -419,35 +534,47 @@ DeviceManagement::OnDateTimeResponse( const SerialMessage& serialMsg, Dictionary
  *
  * @param   serialMsg       incoming HCI message
  *
- * @param   result          decoded data in Json format
+ * @param   result          decoded data in Json format, nullptr for no text
  *
  * @return  true/false
  */
 
 bool
-DeviceManagement::OnSystemOptionsResponse( const SerialMessage& serialMsg, Dictionary& result ) {
+DeviceManagement::OnSystemOptionsResponse( const SerialMessage& serialMsg, Dictionary* result ) {
     //check minimum payload length sID+mID+CRC16
     if ( serialMsg.GetResponsePayloadLength() < ( 4 ) )
         return false;
 
-    uint8_t status                      =   serialMsg.GetResponseStatus();
-    result.append( "Status", _StatusCodes.value( status, "error" ) );
-
+    uint8_t             status          =   serialMsg.GetResponseStatus();
+    SystemOptionsInfo   info            =   {};
     if ( Ok == status ) {
+        info.Options                    =   serialMsg.GetU32( SerialMessage::ResponseData_Index );
+    }
 
-        uint32_t options                =   serialMsg.GetU32( SerialMessage::ResponseData_Index );
-
-        result.append("System Options.Options.APS",
-            ( options & SO_APS )            ? "on" : "off");
-        result.append("System Options.Options.Trace",
-            ( options & SO_Trace )          ? "on" : "off");
-        result.append("System Options.Options.RTC",
-            ( options & SO_RTC )            ? "on" : "off");
-        result.append("System Options.Options.WatchDog",
-            ( options & SO_WatchDog )       ? "on" : "off");
-        result.append("System Options.Options.Startup Event",
-            ( options & SO_StartupEvent )   ? "on" : "off");
-
+    if ( _Client ) {
+        _Client->OnDeviceManagement_SystemOptions( status, info );
+    }
+    if ( result ) {
+        result->append( "Status", _StatusCodes.value( status, "error" ) );
+
+        if ( Ok == status ) {
+            uint32_t options            =   info.Options;
+
+            result->beginObject("System Options");
+            result->beginObject("Options");
+            result->append("APS",
+                ( options & SO_APS )            ? "on" : "off");
+            result->append("Trace",
+                ( options & SO_Trace )          ? "on" : "off");
+            result->append("RTC",
+                ( options & SO_RTC )            ? "on" : "off");
+            result->append("WatchDog",
+                ( options & SO_WatchDog )       ? "on" : "off");
+            result->append("Startup Event",
+                ( options & SO_StartupEvent )   ? "on" : "off");
+            result->close();
+            result->close();
+        }
     }
     return true;
 }
@@ -19,7 +19,7 @@
 #include "Dictionary.h"
 
 //#include <QMap>
-#include "aMap.h"
+#include "aTable.h"
 
 //<! ServiceAccessPoint class for Device Management HCI messages
 class DeviceManagement : public ServiceAccessPoint {
@@ -88,87 +88,165 @@ public:
         FirmwareInfo_MinSize    =   ( 2 + 2 + 10 + 1 ) //Fimrware Version(2) + BuildCount(2) +  BuildDate(10) + FirmwareName( > 1 )
     };
 
-                                        DeviceManagement            ( HardwareSerial& port );
+    //<! decoded Device Info field
+    struct DeviceInfo {
+        uint8_t                 ModuleType;
+        uint32_t                ModuleID;
+        uint32_t                ProductType;
+        uint32_t                ProductID;
+    };
+
+    //<! decoded Firmware Info field, views into the received message, valid during the callback
+    struct FirmwareInfo {
+        uint8_t                 MajorVersion;
+        uint8_t                 MinorVersion;
+        uint16_t                BuildCount;
+        ByteArrayView           BuildDate;      //!< "dd.mm.yyyy", not NUL terminated
+        ByteArrayView           Name;           //!< not NUL terminated
+    };
+
+    //<! decoded Date Time field
+    struct DateTimeInfo {
+        uint32_t                Seconds;        //!< seconds since epoch
+    };
+
+    //<! decoded System Options field
+    struct SystemOptionsInfo {
+        uint32_t                Options;        //!< SystemOptions flags
+    };
+
+    /**
+     * @brief   The Client class, typed events without text formatting.
+     *          Responses carry the HCI status, their info is zero unless status is Ok.
+     */
+
+    class Client {
+
+    public:
+        //<! startup indication
+        virtual void OnDeviceManagement_Startup( const DeviceInfo& /* device */, const FirmwareInfo& /* firmware */ ) { }
+
+        //<! response with status only: ping, set date time, restart device, set system options
+        virtual void OnDeviceManagement_Status( uint8_t /* msgID */, uint8_t /* status */ ) { }
+
+        //<! get device info response
+        virtual void OnDeviceManagement_DeviceInfo( uint8_t /* status */, const DeviceInfo& /* info */ ) { }
+
+        //<! get firmware version response
+        virtual void OnDeviceManagement_FirmwareInfo( uint8_t /* status */, const FirmwareInfo& /* info */ ) { }
+
+        //<! get date time response
+        virtual void OnDeviceManagement_DateTime( uint8_t /* status */, const DateTimeInfo& /* info */ ) { }
+
+        //<! get system options response
+        virtual void OnDeviceManagement_SystemOptions( uint8_t /* status */, const SystemOptionsInfo& /* info */ ) { }
+    };
+
+                                        DeviceManagement            ( UartTx& tx, RequestTracker& requests );
+
+    /**
+     * @brief   set the receiver of typed events, nullptr for none
+     */
+    void                                SetClient                   ( DeviceManagement::Client* client ) { _Client = client; }
 
     /**
      * @brief   send ping request
+     *
+     * @note    all requests: client, if given, is told the decoded response or the timeout
      */
-    bool                                OnPingDevice                ();
+    bool                                OnPingDevice                ( RequestTracker::Client* client = nullptr );
 
     /**
      * @brief   send "get device information"
      */
-    bool                                OnGetDeviceInfo             ();
+    bool                                OnGetDeviceInfo             ( RequestTracker::Client* client = nullptr );
 
     /**
      * @brief   send "get firmware version"
      */
-    bool                                OnGetFirmwareVersion        ();
+    bool                                OnGetFirmwareVersion        ( RequestTracker::Client* client = nullptr );
 
     /**
      * @brief   send "get date time"
      */
-    bool                                OnGetDateTime               ();
+    bool                                OnGetDateTime               ( RequestTracker::Client* client = nullptr );
 
     /**
      * @brief   send "set date time"
      */
-    bool                                OnSetDateTime               ();
+    bool                                OnSetDateTime               ( RequestTracker::Client* client = nullptr );
 
     /**
      * @brief   send "restart device"
      */
-    bool                                OnRestartDevice             ();
+    bool                                OnRestartDevice             ( RequestTracker::Client* client = nullptr );
 
     /**
      * @brief   send "set system options"
      */
-    bool                                OnSetSystemOptions          ( const Dictionary& params );
+    bool                                OnSetSystemOptions          ( const Dictionary& params, RequestTracker::Client* client = nullptr );
 
     /**
      * @brief   send "get system options"
      */
-    bool                                OnGetSystemOptions          ();
+    bool                                OnGetSystemOptions          ( RequestTracker::Client* client = nullptr );
 
 private:
 
     /**
      * @brief   decoder interface for incoming messages
      */
-    bool                                OnDecodeMessage             ( const SerialMessage& serialMsg, Dictionary& result ) override;
+    bool                                OnDecodeMessage             ( const SerialMessage& serialMsg, Dictionary* result ) override;
+
+    /**
+     * @brief   the application is busy, the request may be re-sent later
+     */
+    bool                                IsBusyStatus                ( uint8_t status ) const override { return ApplicationBusy == status; }
 
     /**
      * @brief   message decoder
      */
-    bool                                OnDefaultResponse           ( const SerialMessage& serialMsg, Dictionary& result );
-    bool                                OnStartupIndication         ( const SerialMessage& serialMsg, Dictionary& result );
-    bool                                OnDeviceInfoResponse        ( const SerialMessage& serialMsg, Dictionary& result );
-    bool                                OnFirmwareVersionResponse   ( const SerialMessage& serialMsg, Dictionary& result );
-    bool                                OnDateTimeResponse          ( const SerialMessage& serialMsg, Dictionary& result );
-    bool                                OnSystemOptionsResponse     ( const SerialMessage& serialMsg, Dictionary& result );
+    bool                                OnDefaultResponse           ( const SerialMessage& serialMsg, Dictionary* result );
+    bool                                OnStartupIndication         ( const SerialMessage& serialMsg, Dictionary* result );
+    bool                                OnDeviceInfoResponse        ( const SerialMessage& serialMsg, Dictionary* result );
+    bool                                OnFirmwareVersionResponse   ( const SerialMessage& serialMsg, Dictionary* result );
+    bool                                OnDateTimeResponse          ( const SerialMessage& serialMsg, Dictionary* result );
+    bool                                OnSystemOptionsResponse     ( const SerialMessage& serialMsg, Dictionary* result );
 
-    Dictionary                          DecodeDeviceInfo            ( const SerialMessage& serialMsg, int index ) const;
-    Dictionary                          DecodeFirmwareInfo          ( const SerialMessage& serialMsg, int index ) const;
+    /**
+     * @brief   field decoders, typed
+     */
+    DeviceInfo                          ParseDeviceInfo             ( const SerialMessage& serialMsg, int index ) const;
+    FirmwareInfo                        ParseFirmwareInfo           ( const SerialMessage& serialMsg, int index ) const;
+
+    /**
+     * @brief   field formatters, text, written in place as an Object of result
+     */
+    void                                DecodeDeviceInfo            ( const SerialMessage& serialMsg, int index, Dictionary* result ) const;
+    void                                DecodeFirmwareInfo          ( const FirmwareInfo& firmware, Dictionary* result ) const;
 
 private:
 
     //<! message decoder prototype
-    typedef bool (DeviceManagement::*Handler)( const SerialMessage& serialMsg, Dictionary& response );
+    typedef bool (DeviceManagement::*Handler)( const SerialMessage& serialMsg, Dictionary* response );
 
-    //<! map with status code strings
+    //<! table with status code strings, flash
     //static const aMap < uint8_t, std::string >  _StatusCodes;
-    static const aMap < uint8_t, const char* >  _StatusCodes;
+    static const aDenseMap < const char*, CommandRejected + 1 >  _StatusCodes;
 
-    //<! map with module types
+    //<! table with module types, flash
     //static const aMap < uint8_t, std::string >  _ModuleTypes;
-    static const aMap < uint8_t, const char* >  _ModuleTypes;
+    static const aSortedMap < uint8_t, const char*, 4 >  _ModuleTypes;
 
-    //<! map with message handler debug info
+    //<! table with message handler debug info, flash
     //static const aMap < uint8_t, std::string >  _EventNames;
-    static const aMap < uint8_t, const char* >  _EventNames;
+    static const aSortedMap < uint8_t, const char*, 9 >  _EventNames;
+
+    //<! table with message handlers, flash
+    static const aSortedMap < uint8_t, Handler, 9 >  _Handlers;
 
-    //<! map with message handlers
-    static const aMap < uint8_t, Handler >  _Handlers;
+    //<! receiver of typed events
+    DeviceManagement::Client*           _Client;
 };
 
 #endif // _Device_Management_H_
@@ -16,39 +16,9 @@
 //#include <cstring>          //nullptr
 #include <stdio.h>
 #include "Dictionary.h"
+#include "HexCodec.h"
 #include <cstring>
 
-static char snBuffer[20];
-
-uint8_t* skipNzeros( uint8_t* ptr, uint16_t n, uint16_t dicsize ) {
-//    uint16_t dicsize = _ByteArray.count();
-//    while( dicsize && n ) {
-//        while( dicsize && *ptr++ ) {
-//            dicsize--;
-//        }
-//        n--;
-//    }
-//    return ptr;
-    //debug--vvv
-    //SerialUSB.println();
-    //debug--^^^
-    if ( 0 == n ) return ptr;
-    uint8_t* i = ptr;
-    for ( ; i < ( ptr + dicsize ); i++ ) {
-        //debug--vvv
-        //SerialUSB.print( (char)*i );
-        //debug--^^^
-        if ( 0 == *i ) {
-            n--;
-            //debug--vvv
-            //SerialUSB.println();
-            //debug--^^^
-        }
-        if ( 0 == n ) return ++i;
-    }
-    return nullptr;
-}
-
 uint16_t scan0FromHere( uint8_t* ptr, uint16_t maxsize ) {
     uint8_t* i = ptr;
     for ( ; i < ( ptr + maxsize ); i++ ) {
@@ -64,7 +34,341 @@ uint16_t scan0FromHere( uint8_t* ptr, uint16_t maxsize ) {
   * @param  buffersize  buffer size
  */
 Dictionary::Dictionary( uint16_t buffersize ) :
-    _ByteArray( buffersize ), _keys( 0 ) {
+    _ByteArray( buffersize ), _Index(), _Truncated( 0 ), _Depth( 0 ) {
+}
+
+/**
+  * @brief  class constructor on arena storage, the records grow into the
+  *         arena, see Arena::Reset(). The index has its own pool storage,
+  *         so the records stay the last allocation and grow in place
+  *
+  * @param  arena       arena outliving the Dictionary contents
+  *         buffersize  initial buffer size
+ */
+Dictionary::Dictionary( Arena& arena, uint16_t buffersize ) :
+    _ByteArray( arena, buffersize ), _Index(), _Truncated( 0 ), _Depth( 0 ) {
+}
+
+/**
+  * @brief  class constructor on fixed storage, see FixedDictionary
+  *
+  * @param  buffer      caller-provided storage
+  *         buffersize  storage size
+  *         index       caller-provided index storage
+  *         indexsize   index storage size
+ */
+Dictionary::Dictionary( uint8_t* buffer, uint16_t buffersize, uint8_t* index, uint16_t indexsize ) :
+    _ByteArray( ByteArray::Fixed, buffer, buffersize ),
+    _Index( ByteArray::Fixed, index, indexsize ),
+    _Truncated( 0 ), _Depth( 0 ) {
+}
+
+/**
+ * @brief   adds an index entry for a record starting at count(), a child
+ *          of the open containers
+ *
+ * @param   keyhash hash of the key of the record
+ *          type    entry type
+ *
+ * @return  false if the index or a container is full, the record must not be written
+ */
+bool
+Dictionary::addEntry( uint16_t keyhash, Type type ) {
+    uint16_t recordoffset = _ByteArray.count();
+    //outer containers count the inner ones, the outermost fills up first
+    for ( uint8_t d = 0; ( d < _Depth ) && ( d < Max_Depth ); d++ ) {
+        if ( ( No_Entry != _Open[d] ) && ( Max_Children <= children( _Open[d] ) ) ) {
+            return false;
+        }
+    }
+    if ( !_Index.reserve( (uint32_t)_Index.count() + Entry_Size ) ) {
+        return false;
+    }
+    _Index.append( (uint8_t)recordoffset );
+    _Index.append( (uint8_t)( recordoffset >> 8 ) );
+    _Index.append( (uint8_t)keyhash );
+    _Index.append( (uint8_t)( keyhash >> 8 ) );
+    _Index.append( (uint8_t)0 );
+    _Index.append( (uint8_t)( type << 4 ) );
+    adopt( 1 );
+    return true;
+}
+
+/**
+ * @brief   counts entries added to the open containers
+ *
+ * @param   entries entries added
+ *
+ * @return  -
+ */
+void
+Dictionary::adopt( uint16_t entries ) {
+    for ( uint8_t d = 0; ( d < _Depth ) && ( d < Max_Depth ); d++ ) {
+        if ( No_Entry != _Open[d] ) {
+            setChildren( _Open[d], children( _Open[d] ) + entries );
+        }
+    }
+}
+
+/**
+ * @brief   opens an Object or Array, a container that does not fit or
+ *          exceeds Max_Depth is still opened and closed, its children go
+ *          to its parent
+ *
+ * @param   akey    key of the container
+ *          type    Object or Array
+ *
+ * @return  false if it does not fit or exceeds Max_Depth, counted in truncated()
+ */
+bool
+Dictionary::open( const char* akey, Type type ) {
+    if ( Max_Depth <= _Depth ) {
+        //not nested deeper, counted like a dropped record
+        _Truncated++;
+        _Depth++;
+        return false;
+    }
+    //the record is the key only, the children follow
+    uint16_t entries = keys();
+    appendRecord( akey, type, nullptr, 0 );
+    if ( entries == keys() ) {
+        _Open[ _Depth++ ] = No_Entry;
+        return false;
+    }
+    _Open[ _Depth++ ] = entries;
+    return true;
+}
+
+/**
+ * @brief   sets the count of entries nested in entry n
+ *
+ * @param   n       entry, < keys()
+ *          count   entries, <= Max_Children
+ *
+ * @return  -
+ */
+void
+Dictionary::setChildren( uint16_t n, uint16_t count ) {
+    uint8_t* entry = _Index.data() + n * Entry_Size;
+    entry[4] = (uint8_t)count;
+    entry[5] = (uint8_t)( ( entry[5] & 0xF0 ) | ( ( count >> 8 ) & 0x0F ) );
+}
+
+/**
+ * @brief   sets the record offset of entry n
+ *
+ * @param   n               entry, < keys()
+ *          recordoffset    offset of record n
+ *
+ * @return  -
+ */
+void
+Dictionary::setOffset( uint16_t n, uint16_t recordoffset ) {
+    uint8_t* entry = _Index.data() + n * Entry_Size;
+    entry[0] = (uint8_t)recordoffset;
+    entry[1] = (uint8_t)( recordoffset >> 8 );
+}
+
+/**
+ * @brief   makes room for needed more bytes of records, counts a
+ *          truncation if the Dictionary can not grow
+ *
+ * @param   needed  bytes to append
+ *
+ * @return  true if the bytes fit
+ */
+bool
+Dictionary::fit( uint32_t needed ) {
+    if ( _ByteArray.reserve( (uint32_t)_ByteArray.count() + needed ) ) {
+        return true;
+    }
+    _Truncated++;
+    return false;
+}
+
+/**
+ * @brief   returns offset of record n
+ *
+ * @param   n   entry, < keys()
+ *
+ * @return  offset of record n
+ */
+uint16_t
+Dictionary::offset( uint16_t n ) const {
+    const uint8_t* entry = _Index.data() + n * Entry_Size;
+    return (uint16_t)( entry[0] | ( entry[1] << 8 ) );
+}
+
+/**
+ * @brief   returns offset next to record n
+ *
+ * @param   n   entry, < keys()
+ *
+ * @return  offset of record n + 1, count() for the last one
+ */
+uint16_t
+Dictionary::end( uint16_t n ) const {
+    return ( n + 1 < keys() ) ? offset( n + 1 ) : _ByteArray.count();
+}
+
+/**
+ * @brief   returns key hash of entry n
+ *
+ * @param   n   entry, < keys()
+ *
+ * @return  key hash of entry n
+ */
+uint16_t
+Dictionary::entryHash( uint16_t n ) const {
+    const uint8_t* entry = _Index.data() + n * Entry_Size;
+    return (uint16_t)( entry[2] | ( entry[3] << 8 ) );
+}
+
+/**
+ * @brief   finds the entry of a key among siblings, keys are compared on a
+ *          hash hit only, the children of a container are skipped
+ *
+ * @param   first   first sibling
+ *          last    end of the siblings
+ *          akey    search key
+ *          keyhash hash of akey
+ *
+ * @return  entry of akey, keys() if not found
+ */
+uint16_t
+Dictionary::find( uint16_t first, uint16_t last, const uint8_t* akey, uint16_t keyhash ) const {
+    for ( uint16_t k = first; k < last; k = next( k ) ) {
+        if ( keyhash != entryHash( k ) ) continue;
+        const uint8_t* testkey = key( k );
+        if ( testkey && ( 0 == strcmp( (const char*)testkey, (const char*)akey ) ) ) {
+            return k;
+        }
+    }
+    return keys();
+}
+
+/**
+ * @brief   returns type of entry n
+ *
+ * @param   n   entry, < keys()
+ *
+ * @return  entry type
+ */
+Dictionary::Type
+Dictionary::type( uint16_t n ) const {
+    const uint8_t* entry = _Index.data() + n * Entry_Size;
+    return (Type)( entry[5] >> 4 );
+}
+
+/**
+ * @brief   returns the number of a U8, U16, U32 or I8 entry
+ *
+ * @param   n   entry, < keys()
+ *
+ * @return  the number, I8 sign extended, 0 for other types
+ */
+uint32_t
+Dictionary::number( uint16_t n ) const {
+    const uint8_t*  pdatan  = data( n );
+    uint16_t        size    = sizeof_data( n );
+    if ( nullptr == pdatan ) return 0;
+    switch ( type( n ) ) {
+        case U8:
+            return pdatan[0];
+        case I8:
+            return (uint32_t)(int32_t)(int8_t)pdatan[0];
+        case U16:
+            return ( 2 <= size ) ? (uint32_t)( pdatan[0] | ( pdatan[1] << 8 ) ) : 0;
+        case U32:
+            return ( 4 <= size ) ?
+                (uint32_t)pdatan[0]           | ( (uint32_t)pdatan[1] << 8 ) |
+                ( (uint32_t)pdatan[2] << 16 ) | ( (uint32_t)pdatan[3] << 24 ) : 0;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief   returns data[n] as text, typed values are formatted into buffer
+ *
+ * @param   n       entry, < keys()
+ *          buffer  text buffer for typed values
+ *          size    buffer size, long Bytes are cut to fit
+ *
+ * @return  0 terminated text, "" for a container
+ */
+const char*
+Dictionary::text( uint16_t n, char* buffer, uint16_t size ) const {
+    const uint8_t*  pdatan  = data( n );
+    uint16_t        bytes;
+    if ( ( 0 == size ) || ( nullptr == buffer ) ) return "";
+    buffer[0] = 0;
+    switch ( type( n ) ) {
+        case Value:
+            return pdatan ? (const char*)pdatan : "";
+        case U8:
+        case U16:
+        case U32:
+            snprintf( buffer, size, "%lu", (unsigned long)number( n ) );
+            break;
+        case I8:
+            snprintf( buffer, size, "%ld", (long)(int32_t)number( n ) );
+            break;
+        case Bytes:
+            //"xx-" per byte, the last one without separator
+            bytes = sizeof_data( n );
+            if ( bytes > size / 3 ) bytes = size / 3;
+            buffer[ HexCodec::Encode( buffer, size - 1, ByteArrayView( pdatan, bytes ), '-' ) ] = 0;
+            break;
+        default:
+            break;
+    }
+    return buffer;
+}
+
+/**
+ * @brief   returns count of entries nested in entry n, incl. grandchildren
+ *
+ * @param   n   entry, < keys()
+ *
+ * @return  0 for a Value
+ */
+uint16_t
+Dictionary::children( uint16_t n ) const {
+    const uint8_t* entry = _Index.data() + n * Entry_Size;
+    return (uint16_t)( entry[4] | ( ( entry[5] & 0x0F ) << 8 ) );
+}
+
+/**
+ * @brief   finds a child of an Object
+ *
+ * @param   n       Object entry
+ *          akey    child key
+ *
+ * @return  child entry, keys() if not found
+ */
+uint16_t
+Dictionary::child( uint16_t n, const Key& akey ) const {
+    if ( ( n >= keys() ) || ( Object != type( n ) ) ) return keys();
+    return find( n + 1, next( n ), (const uint8_t*)akey.Name, akey.Hash );
+}
+
+/**
+ * @brief   finds an item of an Array
+ *
+ * @param   n       Array entry
+ *          i       item position
+ *
+ * @return  item entry, keys() if not found
+ */
+uint16_t
+Dictionary::item( uint16_t n, uint16_t i ) const {
+    if ( ( n >= keys() ) || ( Array != type( n ) ) ) return keys();
+    uint16_t last = next( n );
+    for ( uint16_t k = n + 1; k < last; k = next( k ) ) {
+        if ( 0 == i-- ) return k;
+    }
+    return keys();
 }
 
 /**
@@ -97,7 +401,7 @@ uint16_t    Dictionary::size( void ) const {
  * @return  Dictionary key count
  */
 uint16_t    Dictionary::keys( void ) const {
-    return _keys;
+    return _Index.count() / Entry_Size;
 }
 
 /**
@@ -108,7 +412,9 @@ uint16_t    Dictionary::keys( void ) const {
  * @return  pointer to dictionary key[n]
  */
 uint8_t*    Dictionary::key( uint16_t n ) const {
-    return skipNzeros( _ByteArray.data(), n << 1, _ByteArray.count() );
+    if ( n >= keys() ) return nullptr;
+    uint16_t recordoffset = offset( n );
+    return ( recordoffset < _ByteArray.count() ) ? _ByteArray.data() + recordoffset : nullptr;
 }
 
 /**
@@ -119,7 +425,10 @@ uint8_t*    Dictionary::key( uint16_t n ) const {
  * @return  pointer to dictionary data[n]
  */
 uint8_t*    Dictionary::data( uint16_t n ) const {
-    return skipNzeros( _ByteArray.data(), 1 + ( n << 1 ), _ByteArray.count() );
+    uint8_t*    pkeyn   = key( n );
+    if ( nullptr == pkeyn ) return nullptr;
+    uint8_t*    pdatan  = pkeyn + sizeof_key( n ) + 1;
+    return ( pdatan < _ByteArray.data() + end( n ) ) ? pdatan : nullptr;
 }
 
 /**
@@ -131,10 +440,9 @@ uint8_t*    Dictionary::data( uint16_t n ) const {
  */
 uint16_t
 Dictionary::sizeof_key( uint16_t n ) const {
-    uint16_t    dicsize = _ByteArray.count();
-    uint8_t*    pbegin  = _ByteArray.data();
     uint8_t*    pkeyn   = key( n );
-    return scan0FromHere( pkeyn, dicsize - (uint16_t)( pkeyn - pbegin ) );
+    if ( nullptr == pkeyn ) return 0;
+    return scan0FromHere( pkeyn, end( n ) - offset( n ) );
 }
 
 /**
@@ -146,35 +454,52 @@ Dictionary::sizeof_key( uint16_t n ) const {
  */
 uint16_t
 Dictionary::sizeof_data( uint16_t n ) const {
-    uint16_t    dicsize = _ByteArray.count();
-    uint8_t*    pbegin  = _ByteArray.data();
-    uint8_t*    pkeyn   = data( n );
-    return scan0FromHere( pkeyn, dicsize - (uint16_t)( pkeyn - pbegin ) );
+    uint8_t*    pdatan  = data( n );
+    if ( nullptr == pdatan ) return 0;
+    //the record ends next to the data end separator
+    uint16_t    maxsize = (uint16_t)( _ByteArray.data() + end( n ) - pdatan );
+    if ( Value != type( n ) ) {
+        //typed values have no end separator
+        return maxsize;
+    }
+    if ( 0 == pdatan[ maxsize - 1 ] ) {
+        return maxsize - 1;
+    }
+    return scan0FromHere( pdatan, maxsize );
 }
 
 
 /**
- * @brief   returns byte count in array
+ * @brief   appends text to the data of the last entry, a text Value
  *
- * @param   key and data to append
+ * @param   data        text to append
+ *          Continue    true to extend the data, false to start the data of
+ *                      a record without data
  *
- * @return  byte count in array
+ * @return  byte count in array, nothing is appended and a truncation is
+ *          counted if the last entry is no text Value
  */
 uint16_t
 Dictionary::append( const char* data, bool Continue ) {
-    uint8_t*    plimit  = _ByteArray.data() + _ByteArray.size();
-    //overwrite last 0
-    uint8_t*    pactual = Continue ?
-         ( _ByteArray.count() ? 
-            _ByteArray.data() + _ByteArray.count() - 1:
-            _ByteArray.data() ):
-         _ByteArray.data() + _ByteArray.count();
-    for ( ; pactual < plimit; ) {
-        if ( 0 == ( *pactual++ = (uint8_t)*data++ ) ) goto skip_endmarking;
+    uint16_t    k       = keys();
+    //typed values and containers keep their layout
+    if ( ( 0 == k ) || ( Value != type( k - 1 ) ) ) {
+        _Truncated++;
+        return _ByteArray.count();
     }
-    *( pactual - 1 ) = 0;
-skip_endmarking:
-    _ByteArray.update_count( (uint16_t)( pactual - _ByteArray.data() ) );
+    //Continue overwrites the end separator of the data, never the one of the key
+    bool        extend  = ( nullptr != Dictionary::data( k - 1 ) );
+    if ( extend != Continue ) {
+        _Truncated++;
+        return _ByteArray.count();
+    }
+    uint16_t    size    = strlen( data );
+    if ( !fit( size + ( extend ? 0 : 1 ) ) ) return _ByteArray.count();
+    if ( extend ) {
+        _ByteArray.update_count( _ByteArray.count() - 1 );
+    }
+    _ByteArray.append( (const uint8_t*)data, size );
+    _ByteArray.append( (uint8_t)0 );
     return _ByteArray.count();
 }
 
@@ -189,8 +514,9 @@ skip_endmarking:
 uint16_t
 Dictionary::appendU8( uint8_t n, bool Continue ) {
 
-    snprintf( snBuffer, sizeof( snBuffer ), "%d", n );
-    return append( (const char*)snBuffer, Continue );
+    char buffer[4];
+    snprintf( buffer, sizeof( buffer ), "%u", n );
+    return append( (const char*)buffer, Continue );
 
 }
 
@@ -205,9 +531,9 @@ Dictionary::appendU8( uint8_t n, bool Continue ) {
 uint16_t
 Dictionary::appendU32( uint32_t n, bool Continue ) {
 
-    //const char* format = "%d";
-    snprintf( snBuffer, sizeof( snBuffer ), "%d", n );
-    return append( (const char*)snBuffer, Continue );
+    char buffer[11];
+    snprintf( buffer, sizeof( buffer ), "%lu", (unsigned long)n );
+    return append( (const char*)buffer, Continue );
 
 }
 
@@ -221,24 +547,7 @@ Dictionary::appendU32( uint32_t n, bool Continue ) {
   */
 uint16_t
 Dictionary::append( const char* akey, char* data ) {
-    _keys++;
-/*    uint8_t*    plimit  = _ByteArray.data() + _ByteArray.size();
-    uint8_t*    pactual = _ByteArray.data() + _ByteArray.count();
-    for ( ; pactual < plimit; ) {
-        if ( 0 == ( *pactual++ = (uint8_t)*akey++ ) ) goto skip_endmarking1;
-    }
-    *( pactual - 1 ) = 0;
-skip_endmarking1:
-    for ( ; pactual < plimit; ) {
-        if ( 0 == ( *pactual++ = (uint8_t)*data++ ) ) goto skip_endmarking2;
-    }
-    *( pactual - 1 ) = 0;
-skip_endmarking2:
-    _ByteArray.update_count( (uint16_t)( pactual - _ByteArray.data() ) );
-    return _ByteArray.count();
-*/
-    return append( akey, false ) + append( data, false );
-
+    return appendRecord( akey, Value, (const uint8_t*)data, strlen( data ), true );
 }
 
 
@@ -251,21 +560,7 @@ skip_endmarking2:
   */
 uint16_t
 Dictionary::append( const char* akey, const char* data ) {
-    _keys++;
-    uint8_t*    plimit  = _ByteArray.data() + _ByteArray.size();
-    uint8_t*    pactual = _ByteArray.data() + _ByteArray.count();
-    for ( ; pactual < plimit; ) {
-        if ( 0 == ( *pactual++ = (uint8_t)*akey++ ) ) goto skip_endmarking3;
-    }
-    *( pactual - 1 ) = 0;
-skip_endmarking3:
-    for ( ; pactual < plimit; ) {
-        if ( 0 == ( *pactual++ = (uint8_t)*data++ ) ) goto skip_endmarking4;
-    }
-    *( pactual - 1 ) = 0;
-skip_endmarking4:
-    _ByteArray.update_count( (uint16_t)( pactual - _ByteArray.data() ) );
-    return _ByteArray.count();
+    return appendRecord( akey, Value, (const uint8_t*)data, strlen( data ), true );
 }
 
 
@@ -278,21 +573,7 @@ skip_endmarking4:
   */
 uint16_t
 Dictionary::append( const char* akey, const uint8_t* data ) {
-    _keys++;
-    uint8_t*    plimit  = _ByteArray.data() + _ByteArray.size();
-    uint8_t*    pactual = _ByteArray.data() + _ByteArray.count();
-    for ( ; pactual < plimit; ) {
-        if ( 0 == ( *pactual++ = (uint8_t)*akey++ ) ) goto skip_endmarking5;
-    }
-    *( pactual - 1 ) = 0;
-skip_endmarking5:
-    for ( ; pactual < plimit; ) {
-        if ( 0 == ( *pactual++ = (uint8_t)*data++ ) ) goto skip_endmarking6;
-    }
-    *( pactual - 1 ) = 0;
-skip_endmarking6:
-    _ByteArray.update_count( (uint16_t)( pactual - _ByteArray.data() ) );
-    return _ByteArray.count();
+    return appendRecord( akey, Value, data, strlen( (const char*)data ), true );
 }
 
 
@@ -305,71 +586,119 @@ skip_endmarking6:
   */
 uint16_t
 Dictionary::append( const char* akey, const uint8_t* data, int size ) {
-    _keys++;
-    uint8_t*    plimit  = _ByteArray.data() + _ByteArray.size();
-    uint8_t*    pactual = _ByteArray.data() + _ByteArray.count();
+    if ( size < 0 ) {
+        return appendRecord( akey, Value, data, strlen( (const char*)data ), true );
+    }
+    //constant size data gets an end separator unless it ends with 0
+    return appendRecord( akey, Value, data, (uint16_t)size,
+        ( 0 < size ) && data[ size - 1 ] );
+}
 
-    if ( pactual < plimit ) {
-        for ( ; pactual < plimit; ) {
-            if ( 0 == ( *pactual++ = (uint8_t)*akey++ ) ) goto skip_endmarking7;
-        }
-        *( pactual - 1 ) = 0;   //ja izmet peec for nosaciijuma
+
+/**
+ * @brief   appends a record "key\0" and size value bytes, whole or not at
+ *          all, a record not written is counted as truncated
+ *
+ * @param   akey        key
+ *          type        entry type
+ *          value       value bytes
+ *          size        value byte count
+ *          separator   true to end the value with 0, text
+ *
+ * @return  byte count in array
+ */
+uint16_t
+Dictionary::appendRecord( const char* akey, Type type, const uint8_t* value, uint16_t size, bool separator ) {
+    uint16_t keysize = strlen( akey ) + 1;
+    //the whole record fits and has its entry, or nothing is written
+    if ( !fit( (uint32_t)keysize + size + ( separator ? 1 : 0 ) ) ) return _ByteArray.count();
+    if ( !addEntry( hash( akey ), type ) ) {
+        _Truncated++;
+        return _ByteArray.count();
     }
-skip_endmarking7:
-    if ( size < 0 ) {
-        if ( pactual < plimit ) {
-            for ( ; pactual < plimit; ) {
-                if ( 0 == ( *pactual++ = *data++ ) ) goto skip_endmarking8;
-            }
-            *( pactual - 1 ) = 0;   //ja izmet peec for nosaciijuma
-        }
-skip_endmarking8:
-        ;
-    } else {
-        //constant data size if allowed
-        while ( size-- ) {
-            if ( pactual < plimit ) {
-                *pactual++ = *data++;
-            }
-        }
-        if ( *( pactual - 1 ) ) {
-            if ( pactual < plimit ) {
-                *pactual++ = 0;
-            } else {
-                *( pactual - 1 ) = 0;
-            }
-        }
+    _ByteArray.append( (const uint8_t*)akey, keysize );
+    if ( size ) {
+        _ByteArray.append( value, size );
+    }
+    if ( separator ) {
+        _ByteArray.append( (uint8_t)0 );
     }
-    _ByteArray.update_count( (uint16_t)( pactual - _ByteArray.data() ) );
     return _ByteArray.count();
 }
 
 
 /**
- * @brief   returns byte count in array
+ * @brief   appends a U8 entry, binary
  *
- * @param   key and data to append
+ * @param   akey    key
+ *          n       value
  *
  * @return  byte count in array
  */
 uint16_t
 Dictionary::append( const char* akey, uint8_t n ) {
-    _keys++;
-    return append( akey, false ) + appendU8( n, false );
+    return appendRecord( akey, U8, &n, 1 );
 }
 
 
 /**
- * @brief   returns byte count in array
+ * @brief   appends a U16 entry, binary
  *
- * @param   key and data to append
+ * @param   akey    key
+ *          n       value
+ *
+ * @return  byte count in array
+ */
+uint16_t
+Dictionary::append( const char* akey, uint16_t n ) {
+    uint8_t bytes[2] = { (uint8_t)n, (uint8_t)( n >> 8 ) };
+    return appendRecord( akey, U16, bytes, sizeof( bytes ) );
+}
+
+
+/**
+ * @brief   appends a U32 entry, binary
+ *
+ * @param   akey    key
+ *          n       value
  *
  * @return  byte count in array
  */
 uint16_t
 Dictionary::append( const char* akey, uint32_t n ) {
-    _keys++;
-    return append( akey, false ) + appendU32( n, false );
+    uint8_t bytes[4] = {
+        (uint8_t)n,             (uint8_t)( n >> 8 ),
+        (uint8_t)( n >> 16 ),   (uint8_t)( n >> 24 )
+    };
+    return appendRecord( akey, U32, bytes, sizeof( bytes ) );
+}
+
+
+/**
+ * @brief   appends an I8 entry, binary
+ *
+ * @param   akey    key
+ *          n       value
+ *
+ * @return  byte count in array
+ */
+uint16_t
+Dictionary::append( const char* akey, int8_t n ) {
+    return appendRecord( akey, I8, (const uint8_t*)&n, 1 );
+}
+
+
+/**
+ * @brief   appends a Bytes entry, raw, hex text on demand
+ *
+ * @param   akey    key
+ *          aView   bytes
+ *
+ * @return  byte count in array
+ */
+uint16_t
+Dictionary::appendBytes( const char* akey, const ByteArrayView& aView ) {
+    return appendRecord( akey, Bytes, aView.data(), aView.count() );
 }
 
 
@@ -382,37 +711,9 @@ Dictionary::append( const char* akey, uint32_t n ) {
   */
 uint16_t
 Dictionary::append( const char* akey, std::string& aString ) {
-    //void fromCString(const char* aCString) {
-    //    _size = std::strlen(aCString);
-    //    _count = _size;
-    //    _data = new uint8_t[_size];
-    //    std::memcpy(_data, reinterpret_cast<const uint8_t*>(aCString), _size);
-    //}
-    _keys++;
-    uint8_t*    plimit  = _ByteArray.data() + _ByteArray.size();
-    uint8_t*    pactual = _ByteArray.data() + _ByteArray.count();
-    for ( ; pactual < plimit; ) {
-        if ( 0 == ( *pactual++ = (uint8_t)*akey++ ) ) goto skip_endmarking9;
-    }
-    *( pactual - 1 ) = 0;   //ja izmet peec for nosaciijuma
-skip_endmarking9:
-    char c;
-    for ( uint16_t i = 0; i < aString.size(); ++i ) {
-        c = aString[i];
-        if ( pactual < plimit ) {
-            *pactual++ = c;
-        }
-        if ( 0 == c ) break;
-    }
-    if ( *( pactual - 1 ) ) {
-        if ( pactual < plimit ) {
-            *pactual++ = 0;
-        } else {
-            *( pactual - 1 ) = 0;
-        }
-    }
-    _ByteArray.update_count( (uint16_t)( pactual - _ByteArray.data() ) );
-    return _ByteArray.count();
+    //the data ends at the first 0, an empty string leaves the key only
+    uint16_t    datasize = strlen( aString.c_str() );
+    return appendRecord( akey, Value, (const uint8_t*)aString.c_str(), datasize, 0 < datasize );
 }
 
 
@@ -425,37 +726,9 @@ skip_endmarking9:
   */
 uint16_t
 Dictionary::append( const char* akey, std::string&& aString ) {
-    //void fromCString(const char* aCString) {
-    //    _size = std::strlen(aCString);
-    //    _count = _size;
-    //    _data = new uint8_t[_size];
-    //    std::memcpy(_data, reinterpret_cast<const uint8_t*>(aCString), _size);
-    //}
-    _keys++;
-    uint8_t*    plimit  = _ByteArray.data() + _ByteArray.size();
-    uint8_t*    pactual = _ByteArray.data() + _ByteArray.count();
-    for ( ; pactual < plimit; ) {
-        if ( 0 == ( *pactual++ = (uint8_t)*akey++ ) ) goto skip_endmarkingA;
-    }
-    *( pactual - 1 ) = 0;   //ja izmet peec for nosaciijuma
-skip_endmarkingA:
-    char c;
-    for ( uint16_t i = 0; i < aString.size(); ++i ) {
-        c = aString[i];
-        if ( pactual < plimit ) {
-            *pactual++ = c;
-        }
-        if ( 0 == c ) break;
-    }
-    if ( *( pactual - 1 ) ) {
-        if ( pactual < plimit ) {
-            *pactual++ = 0;
-        } else {
-            *( pactual - 1 ) = 0;
-        }
-    }
-    _ByteArray.update_count( (uint16_t)( pactual - _ByteArray.data() ) );
-    return _ByteArray.count();
+    //the data ends at the first 0, an empty string leaves the key only
+    uint16_t    datasize = strlen( aString.c_str() );
+    return appendRecord( akey, Value, (const uint8_t*)aString.c_str(), datasize, 0 < datasize );
 }
 
 
@@ -469,7 +742,7 @@ skip_endmarkingA:
 /*
 uint16_t
 Dictionary::append( const uint8_t* akey, std::string& aString ) {
-    _keys++;
+    if ( !addEntry( hash( (const char*)akey ) ) ) return _ByteArray.count();
     uint8_t*    plimit  = _ByteArray.data() + _ByteArray.size();
     uint8_t*    pactual = _ByteArray.data() + _ByteArray.count();
     for ( ; pactual < plimit; ) {
@@ -488,78 +761,92 @@ Dictionary::append( const uint8_t* akey, std::string& aString ) {
 */
 
 /**
- * @brief   
+ * @brief   appends the entries of aDictionary as an Object, records and
+ *          index entries are copied in bulk, the children come whole or not at all
  *
- * @param   
+ * @param   akey        key of the Object
+ *          aDictionary child entries
  *
- * @return  
+ * @return  byte count appended
  */
 uint16_t
-Dictionary::append( const char* akey, const Dictionary aDictionary, char delimiter ) {
+Dictionary::append( const char* akey, const Dictionary& aDictionary ) {
     uint16_t oldCount = _ByteArray.count();
-    uint8_t b;
-    uint8_t* puint8;
-    //aDictionary keys
-    for ( uint16_t k = 0; k < aDictionary.keys(); k++ ) {
-        //akey, no 0 after
-        if ( _ByteArray.size() == _ByteArray.count() )
-            goto finita;
-        for ( uint16_t i = 0; ; i++ ) {
-            b = (uint8_t)akey[i];
-            if ( 0 == b ) break;
-            _ByteArray.append( b );
-            if ( _ByteArray.size() == _ByteArray.count() )
-                goto finita;
-        }
-        _ByteArray.append( (uint8_t)delimiter );
-        if ( _ByteArray.size() == _ByteArray.count() )
-            goto finita;
-        //key
-        puint8 = aDictionary.key( k );
-        for ( uint16_t i = 0; ; i++ ) {
-            b = puint8[i];
-            _ByteArray.append( b );
-            if ( _ByteArray.size() == _ByteArray.count() )
-                goto finita;
-            if ( 0 == b ) break;
-        }
-        //safety measure ensuring 0 after key
-        if ( _ByteArray.at( _ByteArray.count() ) ) {
-            if ( _ByteArray.size() == _ByteArray.count() ) {
-                goto finita;
-            } else {
-                _ByteArray.append( 0 );
+    if ( open( akey, Object ) ) {
+        uint16_t    entries = aDictionary.keys();
+        uint16_t    first   = keys();
+        uint16_t    base    = _ByteArray.count();
+        bool        whole   = _Index.reserve( (uint32_t)_Index.count() + entries * Entry_Size );
+        for ( uint8_t d = 0; whole && ( d < _Depth ) && ( d < Max_Depth ); d++ ) {
+            if ( No_Entry != _Open[d] ) {
+                whole = ( (uint32_t)children( _Open[d] ) + entries <= Max_Children );
             }
         }
-        //key
-        puint8 = aDictionary.data( k );
-        for ( uint16_t i = 0; i < ( _ByteArray.size() - _ByteArray.count() ); i++ ) {
-            uint8_t b = puint8[i];
-            _ByteArray.append( b );
-            if ( _ByteArray.size() == _ByteArray.count() )
-                goto finita;
-            if ( 0 == b ) break;
-        }
-        //safety measure ensuring 0 after data
-        if ( _ByteArray.at( _ByteArray.count() ) ) {
-            if ( _ByteArray.size() == _ByteArray.count() ) {
-                goto finita;
-            } else {
-                _ByteArray.append( 0 );
+        if ( !whole ) {
+            _Truncated++;
+        } else if ( entries && fit( aDictionary.count() ) ) {
+            _ByteArray.append( aDictionary._ByteArray );
+            _Index.append( aDictionary._Index );
+            for ( uint16_t n = first; n < first + entries; n++ ) {
+                setOffset( n, offset( n ) + base );
             }
+            adopt( entries );
         }
     }
-    if ( _ByteArray.count() == _ByteArray.size() ) {
-finita:
-        //overdose
-        if ( _ByteArray.size() ) {
-            _ByteArray.update_count( _ByteArray.size() - 1 );
-            _ByteArray.append( 0 );
-        }
-    }
+    close();
     return _ByteArray.count() - oldCount;
 }
 
+/**
+ * @brief   opens an Object, the next entries are its children until close()
+ *
+ * @param   akey    key of the Object
+ *
+ * @return  false if it does not fit or exceeds Max_Depth, counted in truncated(),
+ *          the children go to the parent
+ */
+bool
+Dictionary::beginObject( const char* akey ) {
+    return open( akey, Object );
+}
+
+/**
+ * @brief   opens an Array, the next entries are its items until close()
+ *
+ * @param   akey    key of the Array
+ *
+ * @return  false if it does not fit or exceeds Max_Depth, counted in truncated(),
+ *          the items go to the parent
+ */
+bool
+Dictionary::beginArray( const char* akey ) {
+    return open( akey, Array );
+}
+
+/**
+ * @brief   appends an item without key, to an open Array
+ *
+ * @param   data    item data
+ *
+ * @return  byte count in array
+ */
+uint16_t
+Dictionary::appendItem( const char* data ) {
+    return appendRecord( "", Value, (const uint8_t*)data, strlen( data ), true );
+}
+
+/**
+ * @brief   closes the innermost open Object or Array
+ *
+ * @param   -
+ *
+ * @return  -
+ */
+void
+Dictionary::close( void ) {
+    if ( _Depth ) _Depth--;
+}
+
 
 /**
  * @brief   finds if the dictionary contains a record with a given key
@@ -570,28 +857,7 @@ finita:
  */
 const uint8_t*
 Dictionary::contains( const char* akey ) const {
-    uint16_t k;
-    const uint8_t* testkey;
-    const uint8_t* keycopy;
-
-    uint16_t sizeofkey = strlen( akey );    //optimizeet!
-    if ( 0 == sizeofkey++ ) return nullptr; //sizeofkey++ include zero in check
-
-    for ( k = 0; k < _keys; k++ ) {
-        testkey = key( k );
-        for ( keycopy = (const uint8_t*)akey; keycopy < (const uint8_t*)( akey + sizeofkey ); ) {
-            if ( *testkey++ != *keycopy++ ) goto try_next;
-        }
-        if ( (uint16_t)( testkey - _ByteArray.data() ) > _ByteArray.size() ) {
-            //key fits, no data due the size shortage
-            return _ByteArray.data() + _ByteArray.size() - 1;
-        } else {
-            return testkey;
-        }
-try_next:
-        ;   //at least an empty statement as a tribute to the God of labels
-    }
-    return nullptr;
+    return contains( Key( akey ) );
 }
 
 /**
@@ -603,27 +869,29 @@ try_next:
  */
 const uint8_t*
 Dictionary::contains( const uint8_t* akey ) const {
-    uint16_t k;
-    const uint8_t* testkey;
-    const uint8_t* keycopy;
+    return contains( Key( (const char*)akey ) );
+}
 
-    uint16_t sizeofkey = strlen( (const char*)akey );
-    if ( 0 == sizeofkey++ ) return nullptr; //sizeofkey++ include zero in check
+/**
+ * @brief   finds if the dictionary contains a record with a given key
+ *
+ * @param   akey    key with its hash
+ *
+ * @return  the pos of the data
+ */
+const uint8_t*
+Dictionary::contains( const Key& akey ) const {
+    if ( 0 == *akey.Name ) return nullptr;
 
-    for ( k = 0; k < _keys; k++ ) {
-        testkey = key( k );
-        for ( keycopy = akey; keycopy < ( akey + sizeofkey ); ) {
-            if ( *testkey++ != *keycopy++ ) goto try_next;
-        }
-        if ( (uint16_t)( testkey - _ByteArray.data() ) > _ByteArray.size() ) {
-            return _ByteArray.data() + _ByteArray.size() - 1;
-        } else {
-            return testkey;
-        }
-try_next:
-        ;   //at least an empty statement for the God of labels
+    uint16_t n = find( 0, keys(), (const uint8_t*)akey.Name, akey.Hash );
+    if ( n == keys() ) return nullptr;
+
+    const uint8_t* pdatan = data( n );
+    if ( nullptr == pdatan ) {
+        //container or no data due the size shortage, the end separator of the key
+        return key( n ) + sizeof_key( n );
     }
-    return nullptr;
+    return pdatan;
 }
 
 /**
@@ -635,32 +903,50 @@ try_next:
  */
 uint16_t
 Dictionary::remove( const uint8_t* akey ) {
-    uint16_t deleted = 0;
-
-    const uint16_t sizeofkey = strlen( (const char*)akey );
-    if ( 0 == sizeofkey ) return deleted;
-
-    const uint8_t* ptrdata = contains( akey );
-    if ( ptrdata ) {
-        //Houston we have data!
-        //outer frame
-        uint8_t* MrFirst = _ByteArray.data();
-        uint8_t* MrLast  = _ByteArray.data() + _ByteArray.count();  //actually next to last
-        //inner frame
-        uint8_t* first = const_cast<uint8_t*>( ptrdata - 1 - sizeofkey );   //minus zero sugar
-        const uint16_t sizeofdata = strlen( (const char*)ptrdata ); //optimizeet!
-        uint8_t* last  = const_cast<uint8_t*>( ptrdata + sizeofdata + 1 );  //next to zero sugar
-        if ( last > MrLast ) {
-            last = MrLast;
-        }
-        deleted = last - first;
-        if ( deleted < _ByteArray.count() ) {
-            for ( uint8_t* s = last; s < MrLast; )
-                *first++ = *s++;
-            *--first = 0;
-        } else {
-            deleted = _ByteArray.count();
-            _ByteArray.clear();
+    return remove( Key( (const char*)akey ) );
+}
+
+/**
+ * @brief   deletes from the dictionary the record with a given key, a
+ *          container goes with its children
+ *
+ * @param   akey    key with its hash
+ *
+ * @return  the size of the deleted records
+ */
+uint16_t
+Dictionary::remove( const Key& akey ) {
+    if ( 0 == *akey.Name ) return 0;
+
+    uint16_t k = keys();
+    uint16_t n = find( 0, k, (const uint8_t*)akey.Name, akey.Hash );
+    if ( n == k ) return 0;
+
+    //close the gap of the records
+    uint16_t    behind  = next( n );
+    uint16_t    removed = behind - n;
+    uint8_t*    pbegin  = _ByteArray.data();
+    uint16_t    first   = offset( n );
+    uint16_t    last    = ( behind < k ) ? offset( behind ) : _ByteArray.count();
+    uint16_t    deleted = last - first;
+    memmove( pbegin + first, pbegin + last, _ByteArray.count() - last );
+    _ByteArray.update_count( _ByteArray.count() - deleted );
+
+    //drop their entries, the records behind moved down
+    uint8_t*    entry   = _Index.data() + n * Entry_Size;
+    memmove( entry, entry + removed * Entry_Size, ( k - behind ) * Entry_Size );
+    _Index.update_count( _Index.count() - removed * Entry_Size );
+    for ( k -= removed; n < k; n++ ) {
+        setOffset( n, offset( n ) - deleted );
+    }
+
+    //open containers behind moved down too
+    for ( uint8_t d = 0; ( d < _Depth ) && ( d < Max_Depth ); d++ ) {
+        if ( No_Entry == _Open[d] ) continue;
+        if ( _Open[d] >= behind ) {
+            _Open[d] -= removed;
+        } else if ( _Open[d] >= behind - removed ) {
+            _Open[d] = No_Entry;
         }
     }
     return deleted;
@@ -675,7 +961,9 @@ Dictionary::remove( const uint8_t* akey ) {
  */
 void        Dictionary::clear( void ) {
     _ByteArray.clear();
-    _keys = 0;
+    _Index.clear();
+    _Truncated = 0;
+    _Depth = 0;
 }
 
 /**
@@ -687,18 +975,33 @@ void        Dictionary::clear( void ) {
  */
 //void        Dictionary::print( HardwareSerial Serial ) const {
 void        Dictionary::print( void ) const {
-    //key : data
+    //key : data, children indented under their container
     uint16_t maxsizeofkey = 0;
     uint16_t sizeofkeyi;
     uint16_t i;
-    for ( i = 0; i < _keys; i++ ) {
+    uint16_t entries = keys();
+    //ends of the containers i is in, innermost last
+    uint16_t ends[ Max_Depth ];
+    uint8_t  depth = 0;
+    char     buffer[ Text_Size ];
+    for ( i = 0; i < entries; i++ ) {
         sizeofkeyi = sizeof_key( i );
         if ( maxsizeofkey < sizeofkeyi ) maxsizeofkey = sizeofkeyi;
     }
-    for ( i = 0; i < _keys; i++ ) {
+    for ( i = 0; i < entries; i++ ) {
+        while ( depth && ( ends[ depth - 1 ] <= i ) ) depth--;
+        for ( uint8_t d = 0; d < depth; d++ ) {
+            printf("  ");
+        }
+        if ( ( Object == type( i ) ) || ( Array == type( i ) ) ) {
+            //Serial.println( (const char*)key( i ) );
+            printf( "%s\r\n", (const char*)key( i ) );
+            if ( depth < Max_Depth ) ends[ depth++ ] = next( i );
+            continue;
+        }
         sizeofkeyi = sizeof_key( i );
         //Serial.print( (const char*)key( i ) );
-        printf( (const char*)key( i ) );
+        printf( "%s", (const char*)key( i ) );
         sizeofkeyi = maxsizeofkey - sizeofkeyi;
         sizeofkeyi++;
         while ( sizeofkeyi-- ) {
@@ -708,7 +1011,8 @@ void        Dictionary::print( void ) const {
         //Serial.print( F(": ") );
         printf(": ");
         //Serial.println( (const char*)data( i ) );
-        printf( (const char*)data( i ) );
+        printf( "%s", text( i, buffer, sizeof( buffer ) ) );
+        printf("\r\n");
     }
 }
 
@@ -757,15 +1061,17 @@ void        Dictionary::print( const char* keys[],
 
     uint16_t maxsizeofkey = 0;
     uint16_t sizeofkey;
-    uint16_t k, i;
+    uint16_t k, i, j;
+    uint16_t entries = Dictionary::keys();
     const char*     akey;
     const uint8_t*  testkey;
-    const uint8_t*  testdata;
+    const char*     testdata;
+    char            buffer[ Text_Size ];
 
     if ( inverse ) {
-        //count only these that do not match!
+        //count only these that do not match, top level only
         
-        for ( i = 0; i < _keys; i++ ) {
+        for ( i = 0; i < entries; i = next( i ) ) {
 
             testkey = key( i );
             for ( k = 0; k < keycount; k++ ) {
@@ -774,13 +1080,13 @@ void        Dictionary::print( const char* keys[],
                     goto SkipThis;
             }
 
-            sizeofkey = strlen( (const char*)testkey );
+            sizeofkey = sizeof_key( i );
             if ( maxsizeofkey < sizeofkey ) maxsizeofkey = sizeofkey;
 
 SkipThis:
             ;
         }
-        for ( i = 0; i < _keys; i++ ) {
+        for ( i = 0; i < entries; i = next( i ) ) {
 
             testkey = key( i );
             for ( k = 0; k < keycount; k++ ) {
@@ -790,17 +1096,19 @@ SkipThis:
             }
 
             //Serial.print( (const char*)testkey );
-            printf( (const char*)testkey );
+            printf( "%s", (const char*)testkey );
 
-            sizeofkey = strlen( (const char*)testkey );
-            for ( i = sizeofkey; i < maxsizeofkey; i++ )
+            sizeofkey = sizeof_key( i );
+            for ( j = sizeofkey; j < maxsizeofkey; j++ )
                 //Serial.print(' ');
                 printf(" ");
             //Serial.print( F(" : ") );
             printf(" : ");
 
             //Serial.println( (const char*)data( i ) );
-            printf( (const char*)data( i ) );
+            //container or no data: an empty line
+            printf( "%s", text( i, buffer, sizeof( buffer ) ) );
+            printf("\r\n");
 
 SkipThisAgain:
             ;
@@ -820,22 +1128,19 @@ SkipThisAgain:
             akey = keys[k];
             sizeofkey = strlen( akey );
             //Serial.print( akey );
-            printf( akey );
+            printf( "%s", akey );
 
-            for ( i = sizeofkey; i < maxsizeofkey; i++ )
+            for ( j = sizeofkey; j < maxsizeofkey; j++ )
                 //Serial.print(' ');
                 printf(" ");
             //Serial.print( F(" : ") );
             printf(" : ");
 
-            testdata = contains( (const uint8_t*)( akey ) );
-            if ( testdata ) {
-                //Serial.println( (const char*)( testdata ) );
-                printf( (const char*)( testdata ) );
-            } else {
-                //Serial.println();
-                printf("\r\n");
-            }
+            i = find( 0, entries, (const uint8_t*)akey, hash( akey ) );
+            testdata = ( i < entries ) ? text( i, buffer, sizeof( buffer ) ) : "";
+            //Serial.println( testdata );
+            printf( "%s", testdata );
+            printf("\r\n");
         }
     }
 }
@@ -19,12 +19,71 @@
 
 /**
  * @brief   The Dictionary class provides methods for Dictionary based on ByteArray.
- *          Dictionary can not contain 0.
+ *          Keys and text values can not contain 0, typed values can.
+ *
+ *          Records are written whole or not at all: the Dictionary grows, into
+ *          an Arena if one is given, only fixed storage drops a record and
+ *          counts it.
+ *
+ *          Records "key\0data\0" are kept back to back, an index of their
+ *          offsets (uint16_t per entry) makes key(n), data(n) and their sizes
+ *          O(1) per entry instead of a scan from the start.
+ *
+ *          Each index entry also keeps a 16 bit hash of its key, a lookup
+ *          compares hashes and only a hash hit compares the key. Constant keys
+ *          hash at compile time:
+ *
+ *          static constexpr Dictionary::Key Status( "Status" );
+ *          const uint8_t* status = result.contains( Status );
+ *
+ *          Entries nest: an Object or Array entry is followed by its child
+ *          entries in the same buffer, its index entry counts them, so a lookup
+ *          skips a whole subtree. contains() and remove() see the top level,
+ *          child() and item() the children of a container:
+ *
+ *          result.beginObject( "Device Info" );
+ *          result.append( "Module ID", id );
+ *          result.close();
+ *
+ *          Numbers and raw bytes are kept binary, "key\0" and the value bytes
+ *          (LSB first), their index entry tags the type. Text is made only when
+ *          print() or text() asks for it.
  */
 
 class Dictionary {
     public:
 
+        /**
+         * @brief   16 bit key hash, FNV-1a folded to 16 bits
+         *
+         * @param   akey    key
+         *
+         * @return  hash of akey
+         */
+        static constexpr uint16_t hash( const char* akey ) {
+                        return fold( fnv( Fnv_Basis, akey ) );
+                    }
+
+        //<! key with its hash, constexpr keys are hashed by the compiler
+        struct Key {
+            const char*     Name;       //!< key
+            uint16_t        Hash;       //!< hash( Name )
+
+            constexpr       Key( const char* akey ) : Name( akey ), Hash( hash( akey ) ) {}
+        };
+
+        //<! entry types
+        enum Type : uint8_t {
+            Value       =   0,      //!< "key\0data\0" record, text
+            Object      =   1,      //!< keyed child entries follow
+            Array       =   2,      //!< child items without key follow
+            U8          =   3,      //!< "key\0" and 1 byte
+            U16         =   4,      //!< "key\0" and 2 bytes, LSB first
+            U32         =   5,      //!< "key\0" and 4 bytes, LSB first
+            I8          =   6,      //!< "key\0" and 1 byte, signed
+            Bytes       =   7       //!< "key\0" and raw bytes, hex text
+        };
+
         /**
           * @brief  class constructor, not initialised buffer
           *
@@ -32,6 +91,16 @@ class Dictionary {
           */
                     Dictionary( uint16_t buffersize = 256 );
 
+        /**
+          * @brief  class constructor on arena storage, the records grow into
+          *         the arena, see Arena::Reset(). The index has its own pool
+          *         storage, so the records grow in place
+          *
+          * @param  arena       arena outliving the Dictionary contents
+          *         buffersize  initial buffer size
+          */
+                    Dictionary( Arena& arena, uint16_t buffersize = 256 );
+
         /**
          * @brief   returns size of data in Dictionary
          *
@@ -50,6 +119,18 @@ class Dictionary {
          */
         uint16_t    size( void ) const;
 
+        /**
+         * @brief   returns count of records dropped since clear(), a record is
+         *          dropped whole, only if the Dictionary can not grow (fixed
+         *          storage, out of memory) or its index is full. A container
+         *          beyond Max_Depth counts too, it is not nested
+         *
+         * @param   -
+         *
+         * @return  truncated record count
+         */
+        uint16_t    truncated( void ) const { return _Truncated; }
+
         /**
          * @brief   returns key count of Dictionary
          *
@@ -77,6 +158,73 @@ class Dictionary {
          */
         uint8_t*    data( uint16_t n ) const;
 
+        /**
+         * @brief   returns type of entry n
+         *
+         * @param   n   entry, < keys()
+         *
+         * @return  entry type
+         */
+        Type        type( uint16_t n ) const;
+
+        /**
+         * @brief   returns the number of a U8, U16, U32 or I8 entry
+         *
+         * @param   n   entry, < keys()
+         *
+         * @return  the number, I8 sign extended, 0 for other types
+         */
+        uint32_t    number( uint16_t n ) const;
+
+        /**
+         * @brief   returns data[n] as text, typed values are formatted into buffer
+         *
+         * @param   n       entry, < keys()
+         *          buffer  text buffer for typed values
+         *          size    buffer size, long Bytes are cut to fit
+         *
+         * @return  0 terminated text, "" for a container
+         */
+        const char* text( uint16_t n, char* buffer, uint16_t size ) const;
+
+        /**
+         * @brief   returns count of entries nested in entry n, incl. grandchildren
+         *
+         * @param   n   entry, < keys()
+         *
+         * @return  0 for a Value
+         */
+        uint16_t    children( uint16_t n ) const;
+
+        /**
+         * @brief   returns the entry behind entry n and its children, the next sibling
+         *
+         * @param   n   entry, < keys()
+         *
+         * @return  next sibling, or the end of the parent
+         */
+        uint16_t    next( uint16_t n ) const { return n + 1 + children( n ); }
+
+        /**
+         * @brief   finds a child of an Object
+         *
+         * @param   n       Object entry
+         *          akey    child key
+         *
+         * @return  child entry, keys() if not found
+         */
+        uint16_t    child( uint16_t n, const Key& akey ) const;
+
+        /**
+         * @brief   finds an item of an Array
+         *
+         * @param   n       Array entry
+         *          i       item position
+         *
+         * @return  item entry, keys() if not found
+         */
+        uint16_t    item( uint16_t n, uint16_t i ) const;
+
         /**
          * @brief   returns key[n] size not including end separator
          *
@@ -96,29 +244,35 @@ class Dictionary {
         uint16_t    sizeof_data( uint16_t n ) const;
 
         /**
-         * @brief   returns byte count in array
+         * @brief   appends text to the data of the last entry, a text Value
          *
-         * @param   key and data to append
+         * @param   data        text
+         *          Continue    true to extend the data, false to start the data
+         *                      of a record without data
          *
-         * @return  byte count in array
+         * @return  byte count in array, unchanged if the last entry is no text Value
          */
         uint16_t    append( const char* data, bool Continue = true );
 
         /**
-         * @brief   returns byte count in array
+         * @brief   appends a number as text to the data of the last entry, a text Value
          *
-         * @param   key and data to append
+         * @param   n           number
+         *          Continue    true to extend the data, false to start the data
+         *                      of a record without data
          *
-         * @return  byte count in array
+         * @return  byte count in array, unchanged if the last entry is no text Value
          */
         uint16_t    appendU8( uint8_t n, bool Continue = true );
 
         /**
-         * @brief   returns byte count in array
+         * @brief   appends a number as text to the data of the last entry, a text Value
          *
-         * @param   key and data to append
+         * @param   n           number
+         *          Continue    true to extend the data, false to start the data
+         *                      of a record without data
          *
-         * @return  byte count in array
+         * @return  byte count in array, unchanged if the last entry is no text Value
          */
         uint16_t    appendU32( uint32_t n, bool Continue = true );
 
@@ -159,23 +313,55 @@ class Dictionary {
         uint16_t    append( const char* akey, const uint8_t* data, int size );
 
         /**
-         * @brief   returns byte count in array
+         * @brief   appends a U8 entry, binary
          *
-         * @param   key and data to append
+         * @param   akey    key
+         *          n       value
          *
          * @return  byte count in array
          */
         uint16_t    append( const char* akey, uint8_t n );
 
         /**
-         * @brief   returns byte count in array
+         * @brief   appends a U16 entry, binary
          *
-         * @param   key and data to append
+         * @param   akey    key
+         *          n       value
+         *
+         * @return  byte count in array
+         */
+        uint16_t    append( const char* akey, uint16_t n );
+
+        /**
+         * @brief   appends a U32 entry, binary
+         *
+         * @param   akey    key
+         *          n       value
          *
          * @return  byte count in array
          */
         uint16_t    append( const char* akey, uint32_t n );
 
+        /**
+         * @brief   appends an I8 entry, binary
+         *
+         * @param   akey    key
+         *          n       value
+         *
+         * @return  byte count in array
+         */
+        uint16_t    append( const char* akey, int8_t n );
+
+        /**
+         * @brief   appends a Bytes entry, raw, hex text on demand
+         *
+         * @param   akey    key
+         *          aView   bytes
+         *
+         * @return  byte count in array
+         */
+        uint16_t    appendBytes( const char* akey, const ByteArrayView& aView );
+
         /**
          * @brief   returns byte count in array
          *
@@ -204,13 +390,53 @@ class Dictionary {
 //        uint16_t    append( const uint8_t* akey, std::string& aString );
 
         /**
-         * @brief   
+         * @brief   appends the entries of aDictionary as an Object, records and
+         *          index entries are copied in bulk
          *
-         * @param   
+         * @param   akey        key of the Object
+         *          aDictionary child entries
          *
-         * @return  
+         * @return  byte count appended
          */
-        uint16_t    append( const char* akey, const Dictionary aDictionary, char delimiter = '.');
+        uint16_t    append( const char* akey, const Dictionary& aDictionary );
+
+        /**
+         * @brief   opens an Object, the next entries are its children until close()
+         *
+         * @param   akey    key of the Object
+         *
+         * @return  false if it does not fit or exceeds Max_Depth, counted in truncated(),
+         *          the children go to the parent
+         */
+        bool        beginObject( const char* akey );
+
+        /**
+         * @brief   opens an Array, the next entries are its items until close()
+         *
+         * @param   akey    key of the Array
+         *
+         * @return  false if it does not fit or exceeds Max_Depth, counted in truncated(),
+         *          the items go to the parent
+         */
+        bool        beginArray( const char* akey );
+
+        /**
+         * @brief   appends an item without key, to an open Array
+         *
+         * @param   data    item data
+         *
+         * @return  byte count in array
+         */
+        uint16_t    appendItem( const char* data );
+
+        /**
+         * @brief   closes the innermost open Object or Array
+         *
+         * @param   -
+         *
+         * @return  -
+         */
+        void        close( void );
 
         /**
          * @brief   finds if the dictionary contains a record with a given key
@@ -230,6 +456,15 @@ class Dictionary {
          */
         const uint8_t*  contains( const uint8_t* akey ) const;
 
+        /**
+         * @brief   finds if the dictionary contains a record with a given key
+         *
+         * @param   akey    key with its hash
+         *
+         * @return  the pos of the data, binary for typed values, see text()
+         */
+        const uint8_t*  contains( const Key& akey ) const;
+
         /**
          * @brief   deletes from the dictionary the record with a given key
          *
@@ -239,6 +474,15 @@ class Dictionary {
          */
         uint16_t    remove( const uint8_t* akey );
 
+        /**
+         * @brief   deletes from the dictionary the record with a given key
+         *
+         * @param   akey    key with its hash
+         *
+         * @return  the size of the deleted record
+         */
+        uint16_t    remove( const Key& akey );
+
         /**
          * @brief   clears the contents of the Dictionary
          *
@@ -289,11 +533,187 @@ class Dictionary {
 //        void        print( USBSerial Serial, const char* keys[],
 //                        const uint16_t keycount, bool inverse = false ) const;
 
+    protected:
+
+        enum {
+            Entry_Size  =   6,      //!< index bytes per entry: record offset, key hash, type and children
+            Max_Depth   =   4,      //!< open Objects and Arrays at a time
+            Max_Children=   0x0FFF, //!< children per container, 4 bits of the count are its type
+            Text_Size   =   64      //!< text buffer of print()
+        };
+
+        /**
+          * @brief  class constructor on fixed storage, see FixedDictionary
+          *
+          * @param  buffer      caller-provided storage
+          *         buffersize  storage size
+          *         index       caller-provided index storage
+          *         indexsize   index storage size
+          */
+                    Dictionary( uint8_t* buffer, uint16_t buffersize, uint8_t* index, uint16_t indexsize );
+
     private:
+
+        //<! no entry
+        static constexpr uint16_t   No_Entry    =   0xFFFF;
+
+        //<! FNV-1a 32 bit offset basis
+        static constexpr uint32_t   Fnv_Basis   =   2166136261UL;
+
+        //<! FNV-1a 32 bit prime
+        static constexpr uint32_t   Fnv_Prime   =   16777619UL;
+
+        /**
+         * @return  FNV-1a hash h continued by byte b
+         */
+        static constexpr uint32_t fnv( uint32_t h, uint8_t b ) {
+                        return ( h ^ b ) * Fnv_Prime;
+                    }
+
+        /**
+         * @return  FNV-1a hash h continued by the string s
+         */
+        static constexpr uint32_t fnv( uint32_t h, const char* s ) {
+                        while ( *s ) {
+                            h = fnv( h, (uint8_t)*s++ );
+                        }
+                        return h;
+                    }
+
+        /**
+         * @return  32 bit hash xor-folded to 16 bits
+         */
+        static constexpr uint16_t fold( uint32_t h ) {
+                        return (uint16_t)( ( h >> 16 ) ^ h );
+                    }
+
+        /**
+         * @brief   adds an index entry for a record starting at count()
+         *
+         * @param   keyhash hash of the key of the record
+         *          type    entry type
+         *
+         * @return  false if the index is full, the record must not be written
+         */
+        bool        addEntry( uint16_t keyhash, Type type = Value );
+
+        /**
+         * @brief   appends a record "key\0" and size value bytes, ended by 0 if
+         *          separator, whole or not at all
+         *
+         * @return  byte count in array
+         */
+        uint16_t    appendRecord( const char* akey, Type type, const uint8_t* value, uint16_t size,
+                        bool separator = false );
+
+        /**
+         * @brief   counts entries added to the open containers
+         */
+        void        adopt( uint16_t entries );
+
+        /**
+         * @brief   opens an Object or Array
+         */
+        bool        open( const char* akey, Type type );
+
+        /**
+         * @brief   sets the count of entries nested in entry n
+         */
+        void        setChildren( uint16_t n, uint16_t count );
+
+        /**
+         * @brief   sets the record offset of entry n
+         */
+        void        setOffset( uint16_t n, uint16_t recordoffset );
+
+        /**
+         * @brief   makes room for needed more bytes of records, counts a
+         *          truncation if the Dictionary can not grow
+         *
+         * @return  true if the bytes fit
+         */
+        bool        fit( uint32_t needed );
+
+        /**
+         * @return  offset of record n
+         */
+        uint16_t    offset( uint16_t n ) const;
+
+        /**
+         * @return  offset next to record n
+         */
+        uint16_t    end( uint16_t n ) const;
+
+        /**
+         * @return  key hash of entry n
+         */
+        uint16_t    entryHash( uint16_t n ) const;
+
+        /**
+         * @return  entry of akey among the siblings first..last, keys() if not found
+         */
+        uint16_t    find( uint16_t first, uint16_t last, const uint8_t* akey, uint16_t keyhash ) const;
+
         //<! ByteArray
         ByteArray       _ByteArray;
-        //<! keys
-        uint16_t        _keys;
+        //<! record offsets and key hashes, Entry_Size per key
+        ByteArray       _Index;
+        //<! records truncated since clear()
+        uint16_t        _Truncated;
+        //<! open containers, innermost last, No_Entry if it did not fit
+        uint16_t        _Open[ Max_Depth ];
+        //<! count of open containers, may exceed Max_Depth
+        uint8_t         _Depth;
+};
+
+
+/**
+ * @brief   The FixedDictionary class is a Dictionary with compile-time size N
+ *          and embedded storage, it never allocates.
+ */
+
+template < uint16_t N = 256 >
+
+class FixedDictionary : public Dictionary {
+
+    static_assert( N > 1, "FixedDictionary: size too small" );
+
+public:
+
+    //<! compile-time size
+    static constexpr uint16_t   Capacity    =   N;
+
+    //<! max entries, one per 8 bytes of records
+    static constexpr uint16_t   Entries     =   ( N < 8 ) ? 1 : ( N / 8 );
+
+        /**
+          * @brief  class constructor
+          */
+                    FixedDictionary( void ) :
+                        Dictionary( _storage, N, _index, Entries * Entry_Size ) {}
+
+        /**
+          * @brief  class copy constructor
+          */
+                    FixedDictionary( const FixedDictionary& other ) :
+                        Dictionary( _storage, N, _index, Entries * Entry_Size ) {
+                        Dictionary::operator = ( other );
+                    }
+
+        /**
+          * @brief  copy assignment operator
+          */
+        FixedDictionary& operator = ( const FixedDictionary& other ) {
+                        Dictionary::operator = ( other );
+                        return *this;
+                    }
+
+private:
+    //<! embedded storage
+    uint8_t         _storage[ N ];
+
+    //<! embedded index storage
+    uint8_t         _index[ Entries * Entry_Size ];
 };
 
 #endif // _Dictionary_H_
@@ -0,0 +1,123 @@
+/**
+ * @file    FixedByteArray.h
+ *
+ * @brief   Declaration of template class FixedByteArray
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _FixedByteArray_H_
+#define _FixedByteArray_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ByteArray.h"
+
+
+/**
+ * @brief   The FixedByteArray class is a ByteArray with compile-time capacity N
+ *          and embedded storage. It never allocates, so its RAM footprint is
+ *          known at link time, it holds exactly N bytes.
+ */
+
+template < uint16_t N >
+
+class FixedByteArray : public ByteArray {
+
+    static_assert( N > 0, "FixedByteArray: capacity must not be 0" );
+
+public:
+
+    //<! compile-time capacity
+    static constexpr uint16_t   Capacity    =   N;
+
+    /**
+      * @brief  class constructor for empty instance
+      */
+                    FixedByteArray( void ) :
+                        ByteArray( ByteArray::Fixed, _storage, N ) {}
+
+    /**
+      * @brief  class constructor, copy of a view
+      *
+      * @param  aView   bytes to copy, truncated to nothing if it does not fit
+      */
+    explicit        FixedByteArray( const ByteArrayView& aView ) :
+                        ByteArray( ByteArray::Fixed, _storage, N ) {
+                        append( aView );
+                    }
+
+    /**
+      * @brief  class copy constructor
+      *
+      * @param  other   FixedByteArray of same capacity
+      */
+                    FixedByteArray( const FixedByteArray& other ) :
+                        ByteArray( ByteArray::Fixed, _storage, N ) {
+                        append( other );
+                    }
+
+    /**
+      * @brief  class copy constructor from smaller FixedByteArray,
+      *         a larger source is a compile-time error
+      *
+      * @param  other   FixedByteArray of capacity M <= N
+      */
+    template < uint16_t M >
+                    FixedByteArray( const FixedByteArray< M >& other ) :
+                        ByteArray( ByteArray::Fixed, _storage, N ) {
+                        static_assert( M <= N, "FixedByteArray: source capacity exceeds destination" );
+                        append( other );
+                    }
+
+    /**
+      * @brief  copy assignment operator
+      *
+      * @param  other   FixedByteArray of same capacity
+      */
+    FixedByteArray& operator = ( const FixedByteArray& other ) {
+                        ByteArray::operator = ( other );
+                        return *this;
+                    }
+
+    /**
+      * @brief  copy assignment operator from smaller FixedByteArray,
+      *         a larger source is a compile-time error
+      *
+      * @param  other   FixedByteArray of capacity M <= N
+      */
+    template < uint16_t M >
+    FixedByteArray& operator = ( const FixedByteArray< M >& other ) {
+                        static_assert( M <= N, "FixedByteArray: source capacity exceeds destination" );
+                        ByteArray::operator = ( other );
+                        return *this;
+                    }
+
+    using ByteArray::append;
+
+    /**
+      * @brief  appends a byte array of compile-time size M,
+      *         M > N is a compile-time error
+      *
+      * @param  bytes   array to append
+      *
+      * @return reference to this FixedByteArray
+      */
+    template < size_t M >
+    FixedByteArray& append( const uint8_t ( &bytes )[M] ) {
+                        static_assert( M <= N, "FixedByteArray: appended array exceeds capacity" );
+                        ByteArray::append( bytes, (uint16_t)M );
+                        return *this;
+                    }
+
+private:
+    //<! embedded storage
+    uint8_t         _storage[ N ];
+};
+
+#endif // _FixedByteArray_H_
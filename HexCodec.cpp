@@ -0,0 +1,264 @@
+/**
+ * @file    HexCodec.cpp
+ *
+ * @brief   Implementation of class HexCodec
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include <cstring>
+#include <algorithm>    //std::reverse
+#include "HexCodec.h"
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#elif defined( __ARM_NEON )
+#include <arm_neon.h>
+#endif
+
+
+//<! invalid entry in decode table
+#define HEX_INVALID     0xFF
+
+
+//<! encode table: byte -> two upper case hex characters
+struct HexEncodeTable {
+    char    Pair[256][2];
+
+    constexpr HexEncodeTable() : Pair() {
+        const char digits[] = "0123456789ABCDEF";
+        for ( int i = 0; i < 256; i++ ) {
+            Pair[i][0] = digits[i >> 4];
+            Pair[i][1] = digits[i & 0x0F];
+        }
+    }
+};
+
+//<! decode table: character -> nibble value or HEX_INVALID
+struct HexDecodeTable {
+    uint8_t Nibble[256];
+
+    constexpr HexDecodeTable() : Nibble() {
+        for ( int i = 0; i < 256; i++ ) {
+            Nibble[i] = HEX_INVALID;
+        }
+        for ( int i = 0; i < 10; i++ ) {
+            Nibble['0' + i] = (uint8_t)i;
+        }
+        for ( int i = 0; i < 6; i++ ) {
+            Nibble['a' + i] = (uint8_t)( 10 + i );
+            Nibble['A' + i] = (uint8_t)( 10 + i );
+        }
+    }
+};
+
+//<! static lookup tables, generated at compile time, placed in flash
+static constexpr HexEncodeTable _EncodeTable;
+static constexpr HexDecodeTable _DecodeTable;
+
+
+/**
+ * @brief   returns size of encoded output
+ *
+ * @param   n           number of bytes to encode
+ * @param   separator   0 for none, else character between bytes
+ *
+ * @return  number of characters, not including a terminating 0
+ */
+uint32_t
+HexCodec::EncodedSize( uint16_t n, char separator ) {
+    if ( 0 == n ) {
+        return 0;
+    }
+    return separator ? ( 3 * (uint32_t)n - 1 ) : ( 2 * (uint32_t)n );
+}
+
+
+/**
+ * @brief   returns size of decoded output
+ *
+ * @param   input       hex characters, non-hex characters are skipped
+ * @param   n           number of characters
+ *
+ * @return  number of bytes Decode() writes
+ */
+uint16_t
+HexCodec::DecodedSize( const char* input, uint32_t n ) {
+    const uint8_t*  pin     = (const uint8_t*)input;
+    const uint8_t*  plimit  = pin + n;
+    uint32_t        digits  = 0;
+    while ( pin < plimit ) {
+        if ( HEX_INVALID != _DecodeTable.Nibble[ *pin++ ] ) {
+            digits++;
+        }
+    }
+    //a trailing single digit makes a byte too
+    return (uint16_t)( ( digits + 1 ) >> 1 );
+}
+
+
+/**
+ * @brief   encode bytes as hex characters
+ *
+ * @param   output      output buffer
+ * @param   outsize     output buffer size
+ * @param   input       bytes to encode
+ * @param   separator   0 for none, else character between bytes
+ * @param   order       MSB_First or LSB_First
+ *
+ * @return  number of characters written, 0 if output is too small
+ */
+uint32_t
+HexCodec::Encode( char* output, uint32_t outsize, const ByteArrayView& input,
+    char separator, Order order ) {
+
+    uint32_t size = EncodedSize( input.count(), separator );
+    if ( ( 0 == size ) || ( size > outsize ) ) {
+        return 0;
+    }
+
+    const uint8_t*  pfirst  = input.data();
+    const uint8_t*  plimit  = pfirst + input.count();
+    char*           pout    = output;
+
+    if ( MSB_First == order ) {
+        if ( 0 == separator ) {
+            return EncodeBulk( output, pfirst, input.count() );
+        }
+        const uint8_t* pin = pfirst;
+        std::memcpy( pout, _EncodeTable.Pair[ *pin++ ], 2 );
+        pout += 2;
+        while ( pin < plimit ) {
+            *pout++ = separator;
+            std::memcpy( pout, _EncodeTable.Pair[ *pin++ ], 2 );
+            pout += 2;
+        }
+    } else {
+        const uint8_t* pin = plimit;
+        std::memcpy( pout, _EncodeTable.Pair[ *--pin ], 2 );
+        pout += 2;
+        while ( pin > pfirst ) {
+            if ( separator ) {
+                *pout++ = separator;
+            }
+            std::memcpy( pout, _EncodeTable.Pair[ *--pin ], 2 );
+            pout += 2;
+        }
+    }
+
+    return size;
+}
+
+
+/**
+ * @brief   decode hex characters into bytes, non-hex characters are skipped,
+ *          a trailing single digit is taken as low nibble
+ *
+ * @param   output      output buffer
+ * @param   outsize     output buffer size, decoding stops when it is full
+ * @param   input       hex characters
+ * @param   n           number of characters
+ * @param   order       MSB_First or LSB_First
+ *
+ * @return  number of bytes written
+ */
+uint16_t
+HexCodec::Decode( uint8_t* output, uint16_t outsize, const char* input, uint32_t n,
+    Order order ) {
+
+    const uint8_t*  pin     = (const uint8_t*)input;
+    const uint8_t*  plimit  = pin + n;
+    uint8_t*        pout    = output;
+    uint8_t*        poutmax = output + outsize;
+    uint8_t         high    = HEX_INVALID;
+
+    while ( ( pin < plimit ) && ( pout < poutmax ) ) {
+        uint8_t nibble = _DecodeTable.Nibble[ *pin++ ];
+        if ( HEX_INVALID == nibble ) {
+            continue;
+        }
+        if ( HEX_INVALID == high ) {
+            high = nibble;
+        } else {
+            *pout++ = (uint8_t)( ( high << 4 ) | nibble );
+            high = HEX_INVALID;
+        }
+    }
+    if ( ( HEX_INVALID != high ) && ( pout < poutmax ) ) {
+        *pout++ = high;
+    }
+
+    if ( LSB_First == order ) {
+        std::reverse( output, pout );
+    }
+    return (uint16_t)( pout - output );
+}
+
+
+/**
+ * @brief   encode a bulk of bytes without separator, MSB first,
+ *          SSE2/NEON on host builds, table-driven elsewhere
+ *
+ * @param   output      output buffer, at least 2 * n characters
+ * @param   input       bytes to encode
+ * @param   n           number of bytes
+ *
+ * @return  number of characters written
+ */
+uint32_t
+HexCodec::EncodeBulk( char* output, const uint8_t* input, uint32_t n ) {
+
+    const uint8_t*  pin     = input;
+    const uint8_t*  plimit  = input + n;
+    char*           pout    = output;
+
+#if defined( __SSE2__ )
+    const __m128i   mask    = _mm_set1_epi8( 0x0F );
+    const __m128i   nine    = _mm_set1_epi8( 9 );
+    const __m128i   zero    = _mm_set1_epi8( '0' );
+    const __m128i   alpha   = _mm_set1_epi8( 'A' - '0' - 10 );
+
+    while ( ( plimit - pin ) >= 16 ) {
+        __m128i bytes   = _mm_loadu_si128( (const __m128i*)pin );
+        __m128i hi      = _mm_and_si128( _mm_srli_epi16( bytes, 4 ), mask );
+        __m128i lo      = _mm_and_si128( bytes, mask );
+        // nibble -> '0'..'9' or 'A'..'F'
+        hi = _mm_add_epi8( _mm_add_epi8( hi, zero ), _mm_and_si128( _mm_cmpgt_epi8( hi, nine ), alpha ) );
+        lo = _mm_add_epi8( _mm_add_epi8( lo, zero ), _mm_and_si128( _mm_cmpgt_epi8( lo, nine ), alpha ) );
+        _mm_storeu_si128( (__m128i*)pout,        _mm_unpacklo_epi8( hi, lo ) );
+        _mm_storeu_si128( (__m128i*)( pout + 16 ), _mm_unpackhi_epi8( hi, lo ) );
+        pin  += 16;
+        pout += 32;
+    }
+#elif defined( __ARM_NEON )
+    const uint8x16_t mask   = vdupq_n_u8( 0x0F );
+    const uint8x16_t nine   = vdupq_n_u8( 9 );
+    const uint8x16_t zero   = vdupq_n_u8( '0' );
+    const uint8x16_t alpha  = vdupq_n_u8( 'A' - '0' - 10 );
+
+    while ( ( plimit - pin ) >= 16 ) {
+        uint8x16_t  bytes   = vld1q_u8( pin );
+        uint8x16x2_t pair;
+        pair.val[0] = vshrq_n_u8( bytes, 4 );
+        pair.val[1] = vandq_u8( bytes, mask );
+        // nibble -> '0'..'9' or 'A'..'F'
+        pair.val[0] = vaddq_u8( vaddq_u8( pair.val[0], zero ), vandq_u8( vcgtq_u8( pair.val[0], nine ), alpha ) );
+        pair.val[1] = vaddq_u8( vaddq_u8( pair.val[1], zero ), vandq_u8( vcgtq_u8( pair.val[1], nine ), alpha ) );
+        vst2q_u8( (uint8_t*)pout, pair );
+        pin  += 16;
+        pout += 32;
+    }
+#endif
+
+    while ( pin < plimit ) {
+        std::memcpy( pout, _EncodeTable.Pair[ *pin++ ], 2 );
+        pout += 2;
+    }
+
+    return (uint32_t)( pout - output );
+}
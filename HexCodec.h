@@ -0,0 +1,103 @@
+/**
+ * @file    HexCodec.h
+ *
+ * @brief   Declaration of class HexCodec
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _HexCodec_H_
+#define _HexCodec_H_
+
+#include <stdint.h>
+#include "ByteArrayView.h"
+
+
+/**
+ * @brief   The HexCodec class provides table-driven, single-pass hex encoding
+ *          and decoding into caller-provided buffers.
+ *
+ * @note    encoding produces upper case digits, decoding accepts both cases
+ *          and skips any non-hex characters (e.g. '-' or ' ' separators)
+ */
+
+class HexCodec {
+
+public:
+
+    //<! byte order
+    enum Order : uint8_t {
+        MSB_First   =   0,      //!< first input byte first
+        LSB_First               //!< last input byte first
+    };
+
+    /**
+     * @brief   returns size of encoded output
+     *
+     * @param   n           number of bytes to encode
+     * @param   separator   0 for none, else character between bytes
+     *
+     * @return  number of characters, not including a terminating 0
+     */
+    static uint32_t     EncodedSize( uint16_t n, char separator = 0 );
+
+    /**
+     * @brief   encode bytes as hex characters
+     *
+     * @param   output      output buffer
+     * @param   outsize     output buffer size
+     * @param   input       bytes to encode
+     * @param   separator   0 for none, else character between bytes
+     * @param   order       MSB_First or LSB_First
+     *
+     * @return  number of characters written, 0 if output is too small
+     *
+     * @note    output is not 0 terminated
+     */
+    static uint32_t     Encode( char* output, uint32_t outsize, const ByteArrayView& input,
+                            char separator = 0, Order order = MSB_First );
+
+    /**
+     * @brief   returns size of decoded output
+     *
+     * @param   input       hex characters, non-hex characters are skipped
+     * @param   n           number of characters
+     *
+     * @return  number of bytes Decode() writes
+     */
+    static uint16_t     DecodedSize( const char* input, uint32_t n );
+
+    /**
+     * @brief   decode hex characters into bytes, non-hex characters are skipped,
+     *          a trailing single digit is taken as low nibble
+     *
+     * @param   output      output buffer
+     * @param   outsize     output buffer size, decoding stops when it is full
+     * @param   input       hex characters
+     * @param   n           number of characters
+     * @param   order       MSB_First or LSB_First
+     *
+     * @return  number of bytes written
+     */
+    static uint16_t     Decode( uint8_t* output, uint16_t outsize, const char* input, uint32_t n,
+                            Order order = MSB_First );
+
+    /**
+     * @brief   encode a bulk of bytes without separator, MSB first,
+     *          SSE2/NEON on host builds, table-driven elsewhere
+     *
+     * @param   output      output buffer, at least 2 * n characters
+     * @param   input       bytes to encode
+     * @param   n           number of bytes
+     *
+     * @return  number of characters written
+     */
+    static uint32_t     EncodeBulk( char* output, const uint8_t* input, uint32_t n );
+};
+
+#endif // _HexCodec_H_
@@ -67,37 +67,37 @@ LoRaMesh_DemoApp::OnExit( void ) {
 
 void
 LoRaMesh_DemoApp::OnPingDevice( void ) {
-    GetDeviceManagement().OnPingDevice();
+    GetDeviceManagement().OnPingDevice( this );
 }
 
 void
 LoRaMesh_DemoApp::OnGetDeviceInformation( void ) {
-    GetDeviceManagement().OnGetDeviceInfo();
+    GetDeviceManagement().OnGetDeviceInfo( this );
 }
 
 void
 LoRaMesh_DemoApp::OnGetFirmwareVersion( void ) {
-    GetDeviceManagement().OnGetFirmwareVersion();
+    GetDeviceManagement().OnGetFirmwareVersion( this );
 }
 
 void
 LoRaMesh_DemoApp::OnGetDateTime( void ) {
-    GetDeviceManagement().OnGetDateTime();
+    GetDeviceManagement().OnGetDateTime( this );
 }
 
 void
 LoRaMesh_DemoApp::OnSetDateTime( void ) {
-    GetDeviceManagement().OnSetDateTime();
+    GetDeviceManagement().OnSetDateTime( this );
 }
 
 void
 LoRaMesh_DemoApp::OnRestartDevice( void ) {
-    GetDeviceManagement().OnRestartDevice();
+    GetDeviceManagement().OnRestartDevice( this );
 }
 
 void
 LoRaMesh_DemoApp::OnGetSystemOptions( void ) {
-    GetDeviceManagement().OnGetSystemOptions();
+    GetDeviceManagement().OnGetSystemOptions( this );
 }
 
 void
@@ -108,7 +108,7 @@ LoRaMesh_DemoApp::OnSetSystemOptions( void ) {
     //params[ "Options" ] = "Trace = off, Startup Event = on";
     params.append("Options", "Trace = off, Startup Event = on");
     //_RadioHub.GetDeviceManagement().OnSetSystemOptions( params );
-    GetDeviceManagement().OnSetSystemOptions( params );
+    GetDeviceManagement().OnSetSystemOptions( params, this );
 
 }
 
@@ -239,36 +239,57 @@ LoRaMesh_DemoApp::OnRadioHub_DataEvent( const Dictionary& result ) {
     printf("LoRaMesh_DemoApp::OnRadioHub_DataEvent\r\n");
     //debug-^^^
 
-    const char* key0 = "Event";
-    const char* key1 = "Status";
-    const char* keys[] = { key0, key1 };
-
 #if 1
     //A
+    //keys hashed at compile time
+    static constexpr Dictionary::Key keys[] = { "Event", "Status" };
+
     Dictionary  data = result;
 
     for ( uint8_t i = 0; i < ( sizeof( keys ) / sizeof( keys[0] ) ); i++ ) {
 
-        const char*     key = keys[i];
-        const uint8_t*  keydata = data.contains( (const uint8_t*)key );
+        const char*     key = keys[i].Name;
+        const uint8_t*  keydata = data.contains( keys[i] );
 
         if ( keydata ) {
             //_HMISerial.print( key );
-            printf( key );
+            printf( "%s", key );
             //_HMISerial.print( " : " );
             printf(" : ");
             //_HMISerial.print( (const char*)keydata );
-            printf( (const char*)keydata );
-            data.remove( (const uint8_t*)key );
+            printf( "%s", (const char*)keydata );
+            printf("\r\n");
+            data.remove( keys[i] );
         }
     }
     data.print();
-    printf("\r\n");
 
 #else
     //B
+    const char* key0 = "Event";
+    const char* key1 = "Status";
+    const char* keys[] = { key0, key1 };
+
     result.print( keys, ( sizeof( keys ) / sizeof( keys[0] ) ) );
     result.print( keys, ( sizeof( keys ) / sizeof( keys[0] ) ), true );
 
 #endif
 }
+
+
+/**
+ * @brief   report requests which did not get a response
+ *
+ * @param   handle      request handle
+ * @param   status      completion
+ * @param   result      decoded response, nullptr unless status is Response
+ */
+void
+LoRaMesh_DemoApp::OnRequestTracker_Complete( uint16_t handle, RequestTracker::Status status, const Dictionary* result ) {
+    if ( RequestTracker::Timeout == status ) {
+        printf( "request %u: no response\r\n", handle );
+    } else if ( RequestTracker::Cancelled == status ) {
+        printf( "request %u: not sent\r\n", handle );
+    }
+    (void)result;
+}
@@ -24,7 +24,8 @@
 //                       , public Console::KeyEventHandler
 //                       , public RadioHub::Client
 //class LoRaMesh_DemoApp : public RadioHub::Client {
-class LoRaMesh_DemoApp : public RadioHub, public RadioHub::Client {
+//class LoRaMesh_DemoApp : public RadioHub, public RadioHub::Client {
+class LoRaMesh_DemoApp : public RadioHub, public RadioHub::Client, public RequestTracker::Client {
 //class LoRaMesh_DemoApp {
 public:
     //                        LoRaMesh_DemoApp         ( Console& console );
@@ -134,6 +135,10 @@ public:
     //<! callback for incoming radio data eventa
     void                    OnRadioHub_DataEvent    ( const Dictionary& result ) override;
 
+    //<! callback for completed requests, the response itself comes with OnRadioHub_DataEvent
+    void                    OnRequestTracker_Complete( uint16_t handle, RequestTracker::Status status,
+                                                       const Dictionary* result ) override;
+
 };
 
 #endif // _LoRa_Mesh_DemoApp_H_
@@ -11,6 +11,7 @@
 
 #include "RadioHub.h"
 #include "printSTDstring.h"
+#include "CurrentTime.h"      //getTimeInMs()
 //#include <QSerialPortInfo>
 
 /**
@@ -20,11 +21,29 @@
  */
 RadioHub::RadioHub( RadioHub::Client& client, HardwareSerial& RadioSerial )
         : _Client           ( client )
-        , _RadioSerial      ( RadioSerial )
-        , _DeviceMgmt       ( RadioSerial )
+        , _Tx               ( RadioSerial )
+        , _Dispatcher       ()
+        , _Requests         ()
+        , _DeviceMgmt       ( _Tx, _Requests )
 //        , _LoRaMeshRouter   ( RadioSerial )
 //        , _Trace            ( RadioSerial )
-        , _SlipDecoder      ( this ) {
+        , _SlipDecoder      ( this )
+        , _RxHead           ( 0 )
+        , _RxTail           ( 0 )
+        , _RxStats          ()
+        , _RadioSerial      ( RadioSerial )
+        , _SerialRx         ( RadioSerial, this )
+        , _Rx               ( &_SerialRx )
+        , _TextEvents       ( true ) {
+
+    //decode into first slot
+    _SlipDecoder.SetOutput( _RxSlots[ _RxHead ].Message );
+
+    //service access points of this stack
+    _Dispatcher.Register( _DeviceMgmt );
+    _DeviceMgmt.SetClient( &_Client );
+//    _Dispatcher.Register( _LoRaMeshRouter );
+//    _Dispatcher.Register( _Trace );
 
     //connect to serial port for ready read events
     //connect( &_Port, SIGNAL( readyRead() ), this, SLOT( OnSerialPort_ReadyRead() ) );
@@ -42,6 +61,8 @@ bool
 RadioHub::Init( void ) {
     //IMHO should check if module is attached!!!
 
+    //messages queued for the old port settings are dropped
+    _Tx.Reset();
     _RadioSerial.end();
     _RadioSerial.begin( 115200, SERIAL_8N1 );
     //_Port.setFlowControl( QSerialPort::NoFlowControl );
@@ -52,13 +73,42 @@ RadioHub::Init( void ) {
     _SerialInfo.append("Config", "SERIAL_8N1");
     _SerialInfo.append("Manufacturer", "STM");
 
-    //clear serial message buffer
-    _RxMessage.clear();
+    //clear serial message buffers
+    for ( uint8_t i = 0; i < Rx_Slots; i++ ) {
+        _RxSlots[i].Message.clear();
+    }
+    _RxHead = 0;
+    _RxTail = 0;
 
-    //reset SLIP decoder
+    //reset SLIP decoder, decode into first slot
     _SlipDecoder.Reset();
+    _SlipDecoder.SetOutput( _RxSlots[ _RxHead ].Message );
+
+    return _Rx->Start();
+}
+
+/**
+ * @brief   use another receive engine
+ *
+ * @param   rx      receive engine, started by Init()
+ */
+void
+RadioHub::SetUartRx( UartRx& rx ) {
+    _Rx->Stop();
+    _Rx->SetClient( nullptr );
+    _Rx = &rx;
+    _Rx->SetClient( this );
+}
 
-    return true;
+/**
+ * @brief   pass a received chunk to the SLIP decoder
+ *
+ * @param   data    received bytes
+ * @param   n       number of bytes
+ */
+void
+RadioHub::OnUartRx_Data( const uint8_t* data, uint32_t n ) {
+    _SlipDecoder.Decode( data, n );
 }
 
 /**
@@ -75,39 +125,162 @@ RadioHub::GetSerial( void ) {
 void
 RadioHub::OnSerialPort_ReadyRead( void ) {
 
-#if 1
-    //A
-    while ( 0 < _RadioSerial.available() ) {
-        //pass incoming byte stream to SLIP decoder
-        //_SlipDecoder.Decode( _RxMessage, _Port.readAll() );
-        _SlipDecoder.Decode( _RxMessage, _RadioSerial.read() );
+    //chunks are passed to OnUartRx_Data()
+    _Rx->Poll();
+}
+
+/**
+ * @brief   feed queued messages to the serial port as far as it has room
+ */
+void
+RadioHub::OnSerialPort_BytesWritten( void ) {
+    _Tx.Poll();
+}
+
+/**
+ * @brief   queue SLIP decoded HCI message, no decoding or printing here,
+ *          so the reader is never stalled by a burst of events
+ *
+ * @param   msg         decoded message, the slot at _RxHead
+ * @param   crcValid    result of the running CRC check in SlipDecoder
+ */
+void
+RadioHub::OnSlipDecoder_MessageReady( const ByteArray& msg, bool crcValid ) {
+
+    uint8_t next = ( _RxHead + 1 ) % Rx_Slots;
+    if ( next == _RxTail ) {
+        //queue full, the decoder reuses the slot for the next frame
+        _RxStats.Dropped++;
+        return;
+    }
+
+    RxSlot& slot = _RxSlots[ _RxHead ];
+    slot.Timestamp = getTimeInMs();
+    slot.CrcValid  = crcValid;
+
+    //publish slot, continue decoding into the next one
+    _RxHead = next;
+    _RxStats.Received++;
+    uint8_t depth = ( _RxHead + Rx_Slots - _RxTail ) % Rx_Slots;
+    if ( depth > _RxStats.HighWater ) {
+        _RxStats.HighWater = depth;
     }
-#else
-    //B
-    _SlipDecoder.Decode( _RxMessage, _RadioSerial.read );
-#endif
+    _SlipDecoder.SetOutput( _RxSlots[ next ].Message );
+    (void)msg;
 }
 
 /**
- * @brief   process SLIP decoded HCI messages
+ * @brief   dispatch queued frames, time out requests, called from main loop
+ *
+ * @param   maxFrames   max frames to dispatch in this call
+ *
+ * @return  number of dispatched frames
+ */
+uint8_t
+RadioHub::DispatchMessages( uint8_t maxFrames ) {
+    uint8_t dispatched = 0;
+
+    //requests without response complete at their clients with Timeout
+    _Requests.Poll();
+
+    while ( ( dispatched < maxFrames ) && ( _RxTail != _RxHead ) ) {
+        dispatchMessage( _RxSlots[ _RxTail ] );
+        //release slot
+        _RxTail = ( _RxTail + 1 ) % Rx_Slots;
+        dispatched++;
+    }
+    return dispatched;
+}
+
+/**
+ * @brief   process a queued HCI message
+ *
+ * @param   slot    queued frame
  */
 void
-RadioHub::OnSlipDecoder_MessageReady( const ByteArray& msg ) {
+RadioHub::dispatchMessage( RxSlot& slot ) {
+
+    if ( _TextEvents ) {
+        printSTDstring( slot.Message.GetHexString() );
+        //printf( slot.Message.GetHexString() );
+    }
 
-    //HCI message is available in _RxMessage, we can ignore incoming param "msg" here
-    //since it points to the same _RxMessage
-    printSTDstring( _RxMessage.GetHexString() );
-    //printf( _RxMessage.GetHexString() );
+    //corrupted frames never reach the SAPs, SlipDecoder counts them
+    if ( !slot.CrcValid ) {
+        printf( "CRC error, dropped frame %lu of %lu\r\n",
+            (unsigned long)_SlipDecoder.GetCrcErrors(), (unsigned long)_SlipDecoder.GetFrames() );
+        return;
+    }
+
+    uint8_t sapID = slot.Message.GetSapID();
+    uint8_t msgID = slot.Message.GetMsgID();
+
+    //a busy response is swallowed while its request waits for the re-send
+    if ( _Requests.Retry( sapID, msgID, slot.Message.GetResponseStatus() ) ) {
+        return;
+    }
 
-    Dictionary result;
+    //the decoded text grows into the event arena, large responses are not truncated
+    Dictionary  result( _EventArena );
+    Dictionary* text = _TextEvents ? &result : nullptr;
 
-    //pass message to message decoder and convert message content into human readable JsonObject
-    if ( ServiceAccessPoint::OnDispatchMessage( _RxMessage, result ) ) {
-        _Client.OnRadioHub_DataEvent( result );
+    //pass message to message decoder, typed events go to the client,
+    //message content is converted into human readable JsonObject for a text consumer only
+    //CRC was already checked by the SLIP decoder
+    if ( _Dispatcher.Dispatch( slot.Message, text, true ) ) {
+        //a response completes its request first, events match none
+        _Requests.Match( sapID, msgID, text );
+        if ( text ) {
+            if ( result.truncated() ) {
+                printf( "decoded text truncated, %u records\r\n", result.truncated() );
+            }
+            _Client.OnRadioHub_DataEvent( result );
+        }
     } else {
         //printSTDstring("No dispachers for: ");
         printf("No dispachers for: ");
-        printSTDstring( _RxMessage.GetHexString() );
+        printSTDstring( slot.Message.GetHexString() );
     }
 
+    //event consumed, the arena is released in one shot
+    _EventArena.Reset();
+}
+
+/**
+ * @brief   returns receive queue statistics
+ *
+ * @param   stats   statistics
+ */
+void
+RadioHub::GetRxStats( RxStats& stats ) const {
+    stats = _RxStats;
+    stats.Depth = ( _RxHead + Rx_Slots - _RxTail ) % Rx_Slots;
+}
+
+/**
+ * @brief   print receive queue and SLIP decoder statistics
+ */
+void
+RadioHub::printRxStats( void ) const {
+    RxStats stats;
+    GetRxStats( stats );
+    printf( "RX queue: %u/%u waiting, high water %u, received %lu, dropped %lu\r\n",
+        stats.Depth, Rx_Slots - 1, stats.HighWater,
+        (unsigned long)stats.Received, (unsigned long)stats.Dropped );
+    _Rx->print();
+    printf( "SLIP decoder: frames %lu, CRC errors %lu, overflows %lu\r\n",
+        (unsigned long)_SlipDecoder.GetFrames(), (unsigned long)_SlipDecoder.GetCrcErrors(),
+        (unsigned long)_SlipDecoder.GetOverflows() );
+    printf( "SAP dispatcher: unknown SAP %lu\r\n", (unsigned long)_Dispatcher.GetUnknownSaps() );
+    _EventArena.print();
+}
+
+/**
+ * @brief   print transmit queue and request statistics
+ */
+void
+RadioHub::printTxStats( void ) const {
+    _Tx.print();
+    _Requests.print();
+    _DeviceMgmt.printRetryStats();
 }
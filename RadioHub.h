@@ -19,24 +19,53 @@
 //#include "ServiceAccessPoints/Trace/Trace.h"
 
 #include "SlipDecoder.h"
+#include "UartRx_Serial.h"
+#include "UartTx.h"
+#include "SapDispatcher.h"
+#include "RequestTracker.h"
 
 //#include <QSerialPort>
 //#include <QJsonObject>
 //#include <QString>
 #include "Dictionary.h"     //also "ByteArray.h"
+#include "Arena.h"
 #include "HardwareSerial.h"
 
 //<! top level interface class for radio module communication
 //class RadioHub : public QObject
 //               , public SlipDecoder::Client
 
-class RadioHub : public SlipDecoder::Client {
+class RadioHub : public SlipDecoder::Client
+               , public UartRx::Client {
 
 public:
-    // declaration of client interface
-    class Client {
+
+    enum {
+        //<! received frame slots, one of them is always being filled by the decoder
+        Rx_Slots            =   4,
+        //<! first chunk of the event arena, a typical decoded message fits
+        Event_Arena_Size    =   512
+    };
+
+    //<! received frame, waiting for dispatch
+    struct RxSlot {
+        FixedSerialMessage<>    Message;        //!< decoded HCI message incl. CRC
+        uint32_t                Timestamp;      //!< getTimeInMs() at frame end
+        bool                    CrcValid;       //!< result of the SLIP decoder CRC check
+    };
+
+    //<! receive queue statistics
+    struct RxStats {
+        uint8_t     Depth;          //!< frames waiting for dispatch
+        uint8_t     HighWater;      //!< max frames waiting ever
+        uint32_t    Received;       //!< frames queued
+        uint32_t    Dropped;        //!< frames dropped, queue full
+    };
+
+    // declaration of client interface, typed events of the SAPs plus decoded data as text
+    class Client : public DeviceManagement::Client {
     public:
-        //<! callback interface for decoded data
+        //<! callback interface for decoded data, only while text events are on
         virtual void    OnRadioHub_DataEvent( const Dictionary& /* result */ ) {}
     };
 
@@ -44,6 +73,15 @@ private:
     //<! reference to client
     RadioHub::Client&   _Client;
 
+    //<! transmit engine, shared by the Service Access Points
+    UartTx              _Tx;
+
+    //<! service access points of this radio stack by SAP ID
+    SapDispatcher       _Dispatcher;
+
+    //<! outstanding requests, shared by the Service Access Points
+    RequestTracker      _Requests;
+
     //<! DeviceManagement Service Access Point
     DeviceManagement    _DeviceMgmt;
 
@@ -56,16 +94,37 @@ private:
     //<! SlipDecoder for incoming messages
     SlipDecoder         _SlipDecoder;
 
-    //<! buffer for incoming messages
-    SerialMessage       _RxMessage;
+    //<! ring of buffers for incoming messages, fixed size, no heap
+    RxSlot              _RxSlots[ Rx_Slots ];
+
+    //<! slot being filled by the decoder, written by reader only
+    volatile uint8_t    _RxHead;
+
+    //<! next slot to dispatch, written by dispatcher only
+    volatile uint8_t    _RxTail;
+
+    //<! receive queue statistics
+    RxStats             _RxStats;
 
     //<! a serial port
     //QSerialPort         _Port;
     HardwareSerial&     _RadioSerial;
 
+    //<! default receive engine, drains the HardwareSerial ISR ring
+    UartRx_Serial       _SerialRx;
+
+    //<! active receive engine
+    UartRx*             _Rx;
+
     //<! connection info
     Dictionary          _SerialInfo;
 
+    //<! format received messages as text for OnRadioHub_DataEvent
+    bool                _TextEvents;
+
+    //<! storage of the decoded text of one message, released when it is consumed
+    FixedArena< Event_Arena_Size >  _EventArena;
+
 public:
                         RadioHub( RadioHub::Client& client, HardwareSerial& RadioSerial );
 
@@ -73,6 +132,12 @@ public:
     //bool                Enable( const QString& portName );
     bool                Init( void );
 
+    //<! accessor for the SAP dispatcher, further SAPs register here
+    SapDispatcher&      GetDispatcher() { return _Dispatcher; }
+
+    //<! accessor for outstanding requests
+    RequestTracker&     GetRequestTracker() { return _Requests; }
+
     //<! accessor for DeviceManagement Service Access Point
     DeviceManagement&   GetDeviceManagement() { return _DeviceMgmt; }
 
@@ -80,17 +145,53 @@ public:
 //    LoRaMeshRouter&     GetLoRaMeshRouter() { return _LoRaMeshRouter; }
 
 //public slots:
-    //<! QSerialPort signal for available serial data
+    //<! QSerialPort signal for available serial data, polls the receive engine
     void                OnSerialPort_ReadyRead( void );
 
+    //<! QSerialPort signal for written bytes, feeds queued messages to the port
+    void                OnSerialPort_BytesWritten( void );
+
+    //<! use another receive engine (DMA, pty), it must deliver the radio byte stream
+    void                SetUartRx( UartRx& rx );
+
+    //<! dispatch queued frames and time out requests from main loop, returns number of dispatched frames
+    uint8_t             DispatchMessages( uint8_t maxFrames = 1 );
+
+    //<! receive queue statistics
+    void                GetRxStats( RxStats& stats ) const;
+
+    //<! print receive queue and SLIP decoder statistics
+    void                printRxStats( void ) const;
+
+    //<! text events on/off, off: typed events only, no formatting, no Dictionary to request clients
+    void                SetTextEvents( bool enable ) { _TextEvents = enable; }
+
+    //<! print transmit queue and request statistics
+    void                printTxStats( void ) const;
+
+    //<! accessor for the event arena statistics, Chunks counts its growth
+    const Arena&        GetEventArena( void ) const { return _EventArena; }
+
+    //<! accessor for the transmit engine
+    UartTx&             GetUartTx( void ) { return _Tx; }
+
     //getSerial
     HardwareSerial      GetSerial( void );
 
+    //<! accessor for SLIP decoder statistics
+    const SlipDecoder&  GetSlipDecoder( void ) const { return _SlipDecoder; }
+
 
 private:
 
-    //<! process SLIP decoded HCI message
-    void                OnSlipDecoder_MessageReady( const ByteArray& msg ) override;
+    //<! pass a received chunk to the SLIP decoder
+    void                OnUartRx_Data( const uint8_t* data, uint32_t n ) override;
+
+    //<! queue SLIP decoded HCI message, decoding continues into the next free slot
+    void                OnSlipDecoder_MessageReady( const ByteArray& msg, bool crcValid ) override;
+
+    //<! process a queued HCI message, frames with CRC error are dropped
+    void                dispatchMessage( RxSlot& slot );
 
 };
 
@@ -0,0 +1,264 @@
+/**
+ * @file    RequestTracker.cpp
+ *
+ * @brief   Implementation of class RequestTracker
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "RequestTracker.h"
+#include "CurrentTime.h"        //getTimeInMs()
+
+
+/**
+ * @brief   class constructor
+ */
+RequestTracker::RequestTracker( void )
+              : _Pending    ( 0 )
+              , _NextHandle ( 1 )
+              , _NextOrder  ( 0 )
+              , _Stats      () {
+    for ( uint8_t i = 0; i < Max_Requests; i++ ) {
+        _Requests[i].Handle = No_Handle;
+    }
+}
+
+
+/**
+ * @brief   track a request before it is sent
+ *
+ * @param   sapID       SAP ID of the request
+ * @param   rspID       message ID of the expected response
+ * @param   client      receiver of the completion, optional
+ * @param   timeout_ms  response timeout
+ * @param   sender      retry policy and re-send, optional
+ * @param   frame       request frame incl. CRC, kept for a retry if it fits Retry_Size
+ * @param   priority    transmit priority class of a re-send
+ *
+ * @return  request handle, No_Handle if the table is full
+ */
+uint16_t
+RequestTracker::Track( uint8_t sapID, uint8_t rspID, RequestTracker::Client* client, uint32_t timeout_ms,
+                       RequestTracker::Sender* sender, const ByteArrayView& frame, SerialMessage::Priority priority ) {
+
+    for ( uint8_t i = 0; i < Max_Requests; i++ ) {
+        Request& request = _Requests[i];
+        if ( No_Handle != request.Handle ) {
+            continue;
+        }
+
+        request.Handle   = _NextHandle;
+        request.Order    = _NextOrder++;
+        request.SapID    = sapID;
+        request.RspID    = rspID;
+        request.Attempt  = 0;
+        request.Backoff  = false;
+        request.Deadline = getTimeInMs() + timeout_ms;
+        request.Timeout  = timeout_ms;
+        request.Client   = client;
+        request.Sender   = sender;
+        request.Priority = priority;
+
+        // a frame too long to keep is not retried
+        request.FrameSize = 0;
+        if ( sender && ( 0 < frame.count() ) && ( frame.count() <= Retry_Size ) ) {
+            memcpy( request.Frame, frame.data(), frame.count() );
+            request.FrameSize = (uint8_t)frame.count();
+        }
+
+        if ( No_Handle == ++_NextHandle ) {
+            _NextHandle = 1;
+        }
+
+        _Stats.Requests++;
+        if ( ++_Pending > _Stats.HighWater ) {
+            _Stats.HighWater = _Pending;
+        }
+        return request.Handle;
+    }
+    _Stats.Rejected++;
+    return No_Handle;
+}
+
+
+/**
+ * @brief   oldest request waiting for this response
+ *
+ * @param   sapID       SAP ID of the received message
+ * @param   msgID       message ID of the received message
+ *
+ * @return  request, nullptr if none, requests in backoff wait for no response
+ */
+RequestTracker::Request*
+RequestTracker::find( uint8_t sapID, uint8_t msgID ) {
+
+    Request* oldest = nullptr;
+    for ( uint8_t i = 0; i < Max_Requests; i++ ) {
+        Request& request = _Requests[i];
+        if ( ( No_Handle == request.Handle ) || request.Backoff
+          || ( sapID != request.SapID ) || ( msgID != request.RspID ) ) {
+            continue;
+        }
+        // oldest by send order distance, wrap safe
+        if ( ( nullptr == oldest ) || ( (int16_t)( request.Order - oldest->Order ) < 0 ) ) {
+            oldest = &request;
+        }
+    }
+    return oldest;
+}
+
+
+/**
+ * @brief   schedule the re-send of the oldest request waiting for this response
+ *          if the sender retries its status
+ *
+ * @param   sapID       SAP ID of the received message
+ * @param   msgID       message ID of the received message
+ * @param   status      response status of the received message
+ *
+ * @return  true if the response is consumed by a retry
+ */
+bool
+RequestTracker::Retry( uint8_t sapID, uint8_t msgID, uint8_t status ) {
+
+    Request* oldest = find( sapID, msgID );
+    if ( ( nullptr == oldest ) || ( 0 == oldest->FrameSize ) ) {
+        return false;
+    }
+
+    uint32_t delay_ms = 0;
+    if ( !oldest->Sender->OnRequestTracker_Retry( status, oldest->Attempt, delay_ms ) ) {
+        return false;
+    }
+    oldest->Attempt++;
+    oldest->Backoff  = true;
+    oldest->Deadline = getTimeInMs() + delay_ms;
+    _Stats.Retries++;
+    return true;
+}
+
+
+/**
+ * @brief   complete the oldest request waiting for this response
+ *
+ * @param   sapID       SAP ID of the received message
+ * @param   msgID       message ID of the received message
+ * @param   result      decoded message, nullptr if not formatted as text
+ *
+ * @return  true if a request was waiting for it
+ */
+bool
+RequestTracker::Match( uint8_t sapID, uint8_t msgID, const Dictionary* result ) {
+
+    Request* oldest = find( sapID, msgID );
+    if ( nullptr == oldest ) {
+        return false;
+    }
+    _Stats.Responses++;
+    complete( *oldest, Response, result );
+    return true;
+}
+
+
+/**
+ * @brief   forget a request, its client is told Cancelled
+ *
+ * @param   handle      request handle
+ *
+ * @return  true if it was in flight
+ */
+bool
+RequestTracker::Cancel( uint16_t handle ) {
+    if ( No_Handle == handle ) {
+        return false;
+    }
+    for ( uint8_t i = 0; i < Max_Requests; i++ ) {
+        if ( handle == _Requests[i].Handle ) {
+            complete( _Requests[i], Cancelled, nullptr );
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief   re-send requests after their backoff, complete timed out requests
+ *
+ * @return  number of timed out requests
+ */
+uint8_t
+RequestTracker::Poll( void ) {
+
+    if ( 0 == _Pending ) {
+        return 0;
+    }
+
+    uint32_t    time    = getTimeInMs();
+    uint8_t     expired = 0;
+    for ( uint8_t i = 0; i < Max_Requests; i++ ) {
+        Request& request = _Requests[i];
+        // wrap safe deadline check
+        if ( ( No_Handle == request.Handle ) || ( (int32_t)( time - request.Deadline ) < 0 ) ) {
+            continue;
+        }
+
+        if ( request.Backoff ) {
+            // the re-sent request queues behind requests sent meanwhile
+            if ( request.Sender->OnRequestTracker_Resend( ByteArrayView( request.Frame, request.FrameSize ), request.Priority ) ) {
+                request.Backoff  = false;
+                request.Order    = _NextOrder++;
+                request.Deadline = time + request.Timeout;
+            } else {
+                complete( request, Cancelled, nullptr );
+            }
+            continue;
+        }
+
+        _Stats.Timeouts++;
+        complete( request, Timeout, nullptr );
+        expired++;
+    }
+    return expired;
+}
+
+
+/**
+ * @brief   free the entry and tell its client
+ *
+ * @param   request     request in flight
+ * @param   status      completion
+ * @param   result      decoded response, nullptr unless status is Response
+ */
+void
+RequestTracker::complete( Request& request, RequestTracker::Status status, const Dictionary* result ) {
+    // free first, the client may send the next request from the callback
+    uint16_t                handle = request.Handle;
+    RequestTracker::Client* client = request.Client;
+    request.Handle = No_Handle;
+    _Pending--;
+
+    if ( client ) {
+        client->OnRequestTracker_Complete( handle, status, result );
+    }
+}
+
+
+/**
+ * @brief   prints request statistics
+ */
+void
+RequestTracker::print( void ) const {
+    printf( "Requests: %u/%u in flight, high water %u, sent %lu, responses %lu, timeouts %lu, rejected %lu, retries %lu\r\n",
+        _Pending, Max_Requests, _Stats.HighWater,
+        (unsigned long)_Stats.Requests, (unsigned long)_Stats.Responses,
+        (unsigned long)_Stats.Timeouts, (unsigned long)_Stats.Rejected,
+        (unsigned long)_Stats.Retries );
+}
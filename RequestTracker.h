@@ -0,0 +1,216 @@
+/**
+ * @file    RequestTracker.h
+ *
+ * @brief   Declaration of class RequestTracker
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _RequestTracker_H_
+#define _RequestTracker_H_
+
+#include <stdint.h>
+#include "Dictionary.h"
+#include "SerialMessage.h"
+
+
+/**
+ * @brief   The RequestTracker class links HCI responses to the requests which
+ *          caused them. Outstanding requests are keyed by (SAP ID, expected
+ *          response message ID); several of them may be in flight per key,
+ *          a response completes the oldest one (FIFO, the radio module answers
+ *          in order). Requests without response complete with Timeout.
+ *
+ *          A response with a busy status may be turned into a retry by the
+ *          Sender (the SAP and its retry policy): the request frame is kept
+ *          and re-sent after the backoff delay, its client only sees the
+ *          final response.
+ */
+
+class RequestTracker {
+
+public:
+
+    enum {
+        //<! max requests in flight
+        Max_Requests        =   8,
+        //<! default response timeout in ms
+        Default_Timeout     =   1000,
+        //<! handle of no request
+        No_Handle           =   0,
+        //<! max request frame size incl. CRC kept for a retry
+        Retry_Size          =   32
+    };
+
+    //<! request completion
+    enum Status : uint8_t {
+        Response        =   0,      //!< response received
+        Timeout,                    //!< no response in time
+        Cancelled                   //!< cancelled, e.g. send failed
+    };
+
+    /**
+     * @brief The Client class
+     */
+
+    class Client {
+
+    public:
+        //<! handler for completed requests, result is nullptr unless status is Response and text events are on
+        virtual void OnRequestTracker_Complete( uint16_t /* handle */, RequestTracker::Status /* status */,
+                                                const Dictionary* /* result */ ) { }
+    };
+
+    /**
+     * @brief The Sender class, retry policy and transmission of re-sent requests
+     */
+
+    class Sender {
+
+    public:
+        //<! decide on a retry for a response status, attempt counts from 0, set the backoff delay
+        virtual bool OnRequestTracker_Retry( uint8_t /* status */, uint8_t /* attempt */, uint32_t& /* delay_ms */ ) { return false; }
+
+        //<! re-send a request frame incl. CRC in its priority class
+        virtual bool OnRequestTracker_Resend( const ByteArrayView& /* frame */, SerialMessage::Priority /* priority */ ) { return false; }
+    };
+
+    //<! request statistics
+    struct Stats {
+        uint32_t    Requests;       //!< requests tracked
+        uint32_t    Responses;      //!< requests completed by response
+        uint32_t    Timeouts;       //!< requests timed out
+        uint32_t    Rejected;       //!< requests not tracked, table full
+        uint32_t    Retries;        //!< requests re-sent after a busy response
+        uint8_t     HighWater;      //!< max requests in flight
+    };
+
+    /**
+     * @brief   class constructor
+     */
+                    RequestTracker( void );
+
+    /**
+     * @brief   track a request before it is sent
+     *
+     * @param   sapID       SAP ID of the request
+     * @param   rspID       message ID of the expected response
+     * @param   client      receiver of the completion, optional
+     * @param   timeout_ms  response timeout
+     * @param   sender      retry policy and re-send, optional
+     * @param   frame       request frame incl. CRC, kept for a retry if it fits Retry_Size
+     * @param   priority    transmit priority class of a re-send
+     *
+     * @return  request handle, No_Handle if the table is full
+     */
+    uint16_t        Track( uint8_t sapID, uint8_t rspID, RequestTracker::Client* client = nullptr,
+                           uint32_t timeout_ms = Default_Timeout,
+                           RequestTracker::Sender* sender = nullptr, const ByteArrayView& frame = ByteArrayView(),
+                           SerialMessage::Priority priority = SerialMessage::Priority_Normal );
+
+    /**
+     * @brief   schedule the re-send of the oldest request waiting for this
+     *          response if the sender retries its status, call before decoding
+     *
+     * @param   sapID       SAP ID of the received message
+     * @param   msgID       message ID of the received message
+     * @param   status      response status of the received message
+     *
+     * @return  true if the response is consumed by a retry
+     */
+    bool            Retry( uint8_t sapID, uint8_t msgID, uint8_t status );
+
+    /**
+     * @brief   complete the oldest request waiting for this response
+     *
+     * @param   sapID       SAP ID of the received message
+     * @param   msgID       message ID of the received message
+     * @param   result      decoded message, nullptr if not formatted as text
+     *
+     * @return  true if a request was waiting for it
+     */
+    bool            Match( uint8_t sapID, uint8_t msgID, const Dictionary* result );
+
+    /**
+     * @brief   forget a request, its client is told Cancelled
+     *
+     * @param   handle      request handle
+     *
+     * @return  true if it was in flight
+     */
+    bool            Cancel( uint16_t handle );
+
+    /**
+     * @brief   re-send requests after their backoff, complete timed out requests,
+     *          call periodically
+     *
+     * @return  number of timed out requests
+     */
+    uint8_t         Poll( void );
+
+    /**
+     * @return  number of requests in flight
+     */
+    uint8_t         GetPending( void ) const { return _Pending; }
+
+    /**
+     * @return  request statistics
+     */
+    const Stats&    GetStats( void ) const { return _Stats; }
+
+    /**
+     * @brief   prints request statistics
+     */
+    void            print( void ) const;
+
+private:
+
+    //<! outstanding request
+    struct Request {
+        uint16_t                Handle;     //!< No_Handle if free
+        uint16_t                Order;      //!< ascending in send order, re-sent requests move back
+        uint8_t                 SapID;      //!< SAP ID
+        uint8_t                 RspID;      //!< expected response message ID
+        uint8_t                 Attempt;    //!< retries so far
+        bool                    Backoff;    //!< waiting for re-send, not for a response
+        uint32_t                Deadline;   //!< ms time stamp of timeout or re-send
+        uint32_t                Timeout;    //!< response timeout in ms
+        RequestTracker::Client* Client;     //!< receiver of the completion
+        RequestTracker::Sender* Sender;     //!< retry policy and re-send
+        SerialMessage::Priority Priority;   //!< transmit priority class
+        uint8_t                 FrameSize;  //!< size of kept frame, 0 if none
+        uint8_t                 Frame[ Retry_Size ];    //!< request frame incl. CRC
+    };
+
+    /**
+     * @brief   oldest request waiting for this response, nullptr if none
+     */
+    Request*        find( uint8_t sapID, uint8_t msgID );
+
+    /**
+     * @brief   free the entry and tell its client
+     */
+    void            complete( Request& request, RequestTracker::Status status, const Dictionary* result );
+
+    //<! outstanding requests
+    Request         _Requests[ Max_Requests ];
+
+    //<! requests in flight
+    uint8_t         _Pending;
+
+    //<! next handle
+    uint16_t        _NextHandle;
+
+    //<! next send order
+    uint16_t        _NextOrder;
+
+    //<! request statistics
+    Stats           _Stats;
+};
+
+#endif // _RequestTracker_H_
@@ -0,0 +1,121 @@
+/**
+ * @file    SapDispatcher.cpp
+ *
+ * @brief   Implementation of class SapDispatcher
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include <string.h>
+#include "SapDispatcher.h"
+#include "ServiceAccessPoint.h"
+
+
+/**
+ * @brief   class constructor, no SAP registered
+ */
+SapDispatcher::SapDispatcher( void )
+             : _UnknownSaps ( 0 ) {
+    memset( _Index, SapDispatcher::No_Sap, sizeof( _Index ) );
+    for ( uint8_t i = 0; i < Max_Saps; i++ ) {
+        _Saps[i] = nullptr;
+    }
+}
+
+
+/**
+ * @brief   register a service access point for its SAP ID
+ *
+ * @param   sap     service access point, must outlive its registration
+ *
+ * @return  true/false, false if the SAP ID is taken or the dispatcher is full
+ */
+bool
+SapDispatcher::Register( ServiceAccessPoint& sap ) {
+
+    uint8_t sapID = sap.GetSapID();
+    if ( SapDispatcher::No_Sap != _Index[ sapID ] ) {
+        return ( &sap == _Saps[ _Index[ sapID ] ] );
+    }
+
+    for ( uint8_t i = 0; i < Max_Saps; i++ ) {
+        if ( nullptr == _Saps[i] ) {
+            _Saps[i] = &sap;
+            _Index[ sapID ] = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief   unregister a service access point
+ *
+ * @param   sap     registered service access point
+ *
+ * @return  true/false, false if it was not registered
+ */
+bool
+SapDispatcher::Unregister( ServiceAccessPoint& sap ) {
+
+    uint8_t sapID = sap.GetSapID();
+    uint8_t i     = _Index[ sapID ];
+    if ( ( SapDispatcher::No_Sap == i ) || ( &sap != _Saps[i] ) ) {
+        return false;
+    }
+    _Saps[i] = nullptr;
+    _Index[ sapID ] = SapDispatcher::No_Sap;
+    return true;
+}
+
+
+/**
+ * @brief   returns registered service access point of a SAP ID
+ *
+ * @param   sapID   SAP ID
+ *
+ * @return  service access point, nullptr if none
+ */
+ServiceAccessPoint*
+SapDispatcher::Find( uint8_t sapID ) const {
+    uint8_t i = _Index[ sapID ];
+    return ( SapDispatcher::No_Sap == i ) ? nullptr : _Saps[i];
+}
+
+
+/**
+ * @brief   check CRC and forward message to the registered service access point
+ *
+ * @param   serialMsg   incoming message
+ *
+ * @param   result      decoded data as text, nullptr if no text consumer is attached
+ *
+ * @param   crcChecked  true if CRC was already verified, e.g. by SlipDecoder
+ *
+ * @return  true/false
+ */
+bool
+SapDispatcher::Dispatch( SerialMessage& serialMsg, Dictionary* result, bool crcChecked ) {
+
+    // unknown SAP is rejected before any work on the message
+    ServiceAccessPoint* sap = Find( serialMsg.GetSapID() );
+    if ( nullptr == sap ) {
+        _UnknownSaps++;
+        return false;
+    }
+
+    // check CRC first, unless it is known to be good
+    if ( !crcChecked && ( false == serialMsg.CheckCRC16() ) )
+        return false;
+
+    serialMsg.RemoveCRC16();
+
+    // call message decoder
+    return sap->OnDecodeMessage( serialMsg, result );
+}
@@ -0,0 +1,101 @@
+/**
+ * @file    SapDispatcher.h
+ *
+ * @brief   Declaration of class SapDispatcher
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _SapDispatcher_H_
+#define _SapDispatcher_H_
+
+#include "SerialMessage.h"
+#include "Dictionary.h"
+
+class ServiceAccessPoint;
+
+
+/**
+ * @brief   The SapDispatcher class forwards received HCI messages to the
+ *          registered ServiceAccessPoint of their SAP ID in constant time.
+ *          Each radio stack owns its dispatcher, so several of them can
+ *          exist side by side.
+ *
+ * @note    the table indexed by SAP ID holds 1 byte per ID, the SAP pointers
+ *          are kept in a small array, 256 + 4 * Max_Saps bytes instead of
+ *          1 kB for 256 pointers
+ */
+
+class SapDispatcher {
+
+public:
+
+    enum {
+        //<! max registered service access points
+        Max_Saps        =   8,
+        //<! table entry of an unregistered SAP ID
+        No_Sap          =   0xFF
+    };
+
+    /**
+     * @brief   class constructor, no SAP registered
+     */
+                    SapDispatcher( void );
+
+    /**
+     * @brief   register a service access point for its SAP ID
+     *
+     * @param   sap     service access point, must outlive its registration
+     *
+     * @return  true/false, false if the SAP ID is taken or the dispatcher is full
+     */
+    bool            Register( ServiceAccessPoint& sap );
+
+    /**
+     * @brief   unregister a service access point
+     *
+     * @param   sap     registered service access point
+     *
+     * @return  true/false, false if it was not registered
+     */
+    bool            Unregister( ServiceAccessPoint& sap );
+
+    /**
+     * @return  registered service access point of sapID, nullptr if none
+     */
+    ServiceAccessPoint* Find( uint8_t sapID ) const;
+
+    /**
+     * @brief   check CRC and forward message to the registered service access point
+     *
+     * @param   serialMsg   incoming message, CRC is removed
+     * @param   result      decoded data as text, nullptr if no text consumer is attached
+     * @param   crcChecked  true if CRC was already verified, e.g. by SlipDecoder
+     *
+     * @return  true/false
+     */
+    bool            Dispatch( SerialMessage& serialMsg, Dictionary* result, bool crcChecked = false );
+
+    /**
+     * @return  number of messages for unregistered SAP IDs
+     */
+    uint32_t        GetUnknownSaps( void ) const { return _UnknownSaps; }
+
+private:
+
+    //<! index into _Saps by SAP ID, No_Sap if unregistered
+    uint8_t                 _Index[ 256 ];
+
+    //<! registered service access points
+    ServiceAccessPoint*     _Saps[ Max_Saps ];
+
+    //<! messages for unregistered SAP IDs
+    uint32_t                _UnknownSaps;
+};
+
+#endif // _SapDispatcher_H_
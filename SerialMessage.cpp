@@ -14,21 +14,30 @@
 
 #include "SerialMessage.h"
 #include "CRC16.h"
+#include "HexCodec.h"
 
 //#include <QDateTime>
 #include <chrono>
 #include <ctime>
 
 
-SerialMessage::SerialMessage() {
+SerialMessage::SerialMessage() :
+    _Priority( Priority_Normal ) {
 }
 
 
-SerialMessage::SerialMessage( uint8_t sapID, uint8_t msgID ) {
+SerialMessage::SerialMessage( uint8_t sapID, uint8_t msgID ) :
+    _Priority( Priority_Normal ) {
     InitRequest( sapID, msgID );
 }
 
 
+SerialMessage::SerialMessage( uint8_t* buffer, uint16_t buffersize ) :
+    ByteArray( ByteArray::Fixed, buffer, buffersize ),
+    _Priority( Priority_Normal ) {
+}
+
+
 uint8_t
 SerialMessage::GetSapID() const {
     if ( count() >= ( Header_Size ) ) {
@@ -140,7 +149,7 @@ SerialMessage::GetData( int index ) const {
 }
 
 
-ByteArray
+ByteArrayView
 SerialMessage::GetPayload( int index, int size ) const {
     if ( size != -1 ) {
         if ( count() >= ( index + size ) ) {
@@ -155,8 +164,8 @@ SerialMessage::GetPayload( int index, int size ) const {
         }
     }
 
-    // return empty array
-    return ByteArray();
+    // return empty view
+    return ByteArrayView();
 }
 
 
@@ -170,32 +179,13 @@ SerialMessage::GetString( int index, int size ) const {
 }
 
 
-static uint8_t _hex_table[16] = {
-        '0', '1', '2', '3',
-        '4', '5', '6', '7',
-        '8', '9', 'A', 'B',
-        'C', 'D', 'E', 'F'
-    };
-
-
 std::string
 SerialMessage::GetHexString( int index , int size ) const {
 
-    ByteArray rawData = GetPayload( index, size );
-
-    std::string result;
-    for( int i = 0; i < rawData.size(); i++ ) {
-
-        result += _hex_table[ rawData.at( i ) >> 4 ];
-        result += _hex_table[ rawData.at( i )  & 7 ];
-        result += '-';
-
-    }
-
-    uint16_t rsize = result.length();
-    if ( rsize )
-            return result.substr( 0, rsize - 1 );
+    ByteArrayView rawData = GetPayload( index, size );
 
+    std::string result( HexCodec::EncodedSize( rawData.count(), '-' ), '\0' );
+    HexCodec::Encode( &result[0], result.size(), rawData, '-' );
     return result;
 }
 
@@ -203,21 +193,10 @@ SerialMessage::GetHexString( int index , int size ) const {
 std::string
 SerialMessage::GetHexString_LSB( int index , int size ) const {
 
-    ByteArray rawData = GetPayload( index, size );
-
-    std::string result;
-    for( int i = rawData.size() - 1; i >= 0; i-- ) {
-
-        result += _hex_table[ rawData.at( i ) >> 4 ];
-        result += _hex_table[ rawData.at( i )  & 7 ];
-        result += "-";
-
-    }
-
-    uint16_t rsize = result.length();
-    if ( rsize )
-            return result.substr( 0, rsize - 1 );
+    ByteArrayView rawData = GetPayload( index, size );
 
+    std::string result( HexCodec::EncodedSize( rawData.count(), '-' ), '\0' );
+    HexCodec::Encode( &result[0], result.size(), rawData, '-', HexCodec::LSB_First );
     return result;
 }
 
@@ -237,8 +216,8 @@ SerialMessage::InitRequest( uint8_t sapID, uint8_t msgID ) {
     clear();
 
     // attach HCI header
-    append( sapID );
-    append( msgID );
+    uint8_t header[Header_Size] = { sapID, msgID };
+    append( header, Header_Size );
 }
 
 
@@ -255,8 +234,11 @@ SerialMessage::Append( uint8_t value ) {
 int
 SerialMessage::Append( uint16_t value ) {
     // LSB first
-    append( (uint8_t)( value ) );
-    append( (uint8_t)( value >> 8 ) );
+    uint8_t bytes[2] = {
+        (uint8_t)( value ),
+        (uint8_t)( value >> 8 )
+    };
+    append( bytes, sizeof( bytes ) );
     // 2 bytes appended
     return 2;
 }
@@ -265,10 +247,13 @@ SerialMessage::Append( uint16_t value ) {
 int
 SerialMessage::Append( uint32_t value ) {
     // LSB first
-    append( (uint8_t)( value ) );
-    append( (uint8_t)( value >> 8 ) );
-    append( (uint8_t)( value >> 16 ) );
-    append( (uint8_t)( value >> 24 ) );
+    uint8_t bytes[4] = {
+        (uint8_t)( value ),
+        (uint8_t)( value >> 8 ),
+        (uint8_t)( value >> 16 ),
+        (uint8_t)( value >> 24 )
+    };
+    append( bytes, sizeof( bytes ) );
     // 4 bytes appended
     return 4;
 }
@@ -277,14 +262,17 @@ SerialMessage::Append( uint32_t value ) {
 int
 SerialMessage::Append( uint64_t value ) {
     // LSB first
-    append( (uint8_t)( value ) );
-    append( (uint8_t)( value >> 8 ) );
-    append( (uint8_t)( value >> 16 ) );
-    append( (uint8_t)( value >> 24 ) );
-    append( (uint8_t)( value >> 32 ) );
-    append( (uint8_t)( value >> 40 ) );
-    append( (uint8_t)( value >> 48 ) );
-    append( (uint8_t)( value >> 56 ) );
+    uint8_t bytes[8] = {
+        (uint8_t)( value ),
+        (uint8_t)( value >> 8 ),
+        (uint8_t)( value >> 16 ),
+        (uint8_t)( value >> 24 ),
+        (uint8_t)( value >> 32 ),
+        (uint8_t)( value >> 40 ),
+        (uint8_t)( value >> 48 ),
+        (uint8_t)( value >> 56 )
+    };
+    append( bytes, sizeof( bytes ) );
     // 8 bytes appended
     return 8;
 }
@@ -292,32 +280,32 @@ SerialMessage::Append( uint64_t value ) {
 
 int
 SerialMessage::AppendHexString( const std::string& input ) {
-    //ByteArray payload = input.toUtf8().replace( '-', "" );
-    ByteArray payload = ByteArray( input );
-    ByteArray data = ByteArray::fromHex( payload ); //ignores '-'
-    if ( data.count() ) {
-        //jaataisa!!!
-        //append( data );
-        for( int i = 0; i < data.count(); i++ )
-            append( data.at( i ) );
-        return data.count();
+    // decode in place behind the current payload, '-' is skipped
+    uint16_t first  = count();
+    uint16_t n      = HexCodec::DecodedSize( input.data(), input.size() );
+    // all bytes or none, a clipped decode would commit a wrong prefix
+    if ( !reserve( (uint32_t)first + n ) ) {
+        return 0;
     }
-    return 0;
+    HexCodec::Decode( data() + first, n, input.data(), input.size() );
+    update_count( first + n );
+    return n;
 }
 
 
 int
 SerialMessage::AppendHexString_LSB( const std::string& input ) {
-    //ByteArray payload = input.toUtf8().replace( '-', "" );
-    ByteArray payload = ByteArray( input );
-    ByteArray data = ByteArray::fromHex( payload );
-
-    if ( data.count() ) {
-        for( int i = data.count() - 1; i >= 0; i-- )
-            append( data.at( i ) );
-        return data.count();
+    // decode in place behind the current payload, '-' is skipped
+    uint16_t first  = count();
+    uint16_t n      = HexCodec::DecodedSize( input.data(), input.size() );
+    // all bytes or none, a clipped decode would commit a wrong prefix
+    if ( !reserve( (uint32_t)first + n ) ) {
+        return 0;
     }
-    return 0;
+    HexCodec::Decode( data() + first, n, input.data(), input.size(),
+        HexCodec::LSB_First );
+    update_count( first + n );
+    return n;
 }
 
 
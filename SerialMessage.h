@@ -47,12 +47,24 @@ public:
         // for reception
         Min_Size                =   ( Header_Size + CRC_Size ),
 
+        // default capacity of fixed message buffers
+        Max_Size                =   256,
+
         // status field in response messages
         EventData_Index         =   2,
         Status_Index            =   2,
         ResponseData_Index      =   3
     };
 
+    // transmit priority class, see UartTx
+    enum Priority : uint8_t
+    {
+        Priority_Control        =   0,  // time-critical control requests, e.g. ping, date/time
+        Priority_Normal,                // default
+        Priority_Bulk,                  // mesh data bursts
+        Num_Priorities
+    };
+
     enum
     {
         InvalidSapID            =   0xFF,
@@ -91,6 +103,16 @@ public:
      */
     uint8_t     GetMsgID() const;
 
+    /**
+     * @brief   tag the message with a transmit priority class
+     */
+    void        SetPriority( Priority priority ) { _Priority = priority; }
+
+    /**
+     * @return  transmit priority class, Priority_Normal if not tagged
+     */
+    Priority    GetPriority() const { return _Priority; }
+
     /**
      * @return  status of response message
      */
@@ -156,11 +178,11 @@ public:
 
 
     /**
-     * @return  array of bytes from payload field
+     * @return  view of bytes from payload field, no data is copied
      *
      * @param   index   index to array
      */
-    ByteArray   GetPayload( int index, int size = -1 ) const;
+    ByteArrayView   GetPayload( int index, int size = -1 ) const;
 
 
     /**
@@ -240,7 +262,7 @@ public:
      *
      * @param   string ( e.g. 00-01-02-03-04... )
      *
-     * @return  number of appended bytes
+     * @return  number of appended bytes, 0 and nothing appended if they do not fit
      */
     int         AppendHexString( const std::string& input );
 
@@ -249,7 +271,7 @@ public:
      *
      * @param   string ( e.g. 00-01-02-03-04... )
      *
-     * @return  number of appended bytes
+     * @return  number of appended bytes, 0 and nothing appended if they do not fit
      */
     int         AppendHexString_LSB( const std::string& input );
 
@@ -259,6 +281,72 @@ public:
      * @return  number of bytes appended (2)
      */
     int         Append_CRC16();
+
+protected:
+
+    /**
+     * @brief   class constructor on fixed storage, see FixedSerialMessage
+     *
+     * @param   buffer      caller-provided storage
+     * @param   buffersize  storage size
+     */
+                SerialMessage( uint8_t* buffer, uint16_t buffersize );
+
+private:
+
+    //<! transmit priority class
+    Priority    _Priority;
+};
+
+
+/**
+ * @brief   The class FixedSerialMessage is a SerialMessage with compile-time
+ *          capacity N and embedded storage, it never allocates.
+ */
+
+template < uint16_t N = SerialMessage::Max_Size >
+
+class FixedSerialMessage : public SerialMessage {
+
+    static_assert( N >= SerialMessage::Min_Size, "FixedSerialMessage: capacity below minimum message size" );
+
+public:
+
+    //<! compile-time capacity
+    static constexpr uint16_t   Capacity    =   N;
+
+    /**
+     * @brief   class constructor
+     */
+                FixedSerialMessage() :
+                    SerialMessage( _storage, N ) {}
+
+                FixedSerialMessage( uint8_t sapID, uint8_t msgID ) :
+                    SerialMessage( _storage, N ) {
+                    InitRequest( sapID, msgID );
+                }
+
+    /**
+     * @brief   class copy constructor
+     */
+                FixedSerialMessage( const FixedSerialMessage& other ) :
+                    SerialMessage( _storage, N ) {
+                    append( other );
+                    SetPriority( other.GetPriority() );
+                }
+
+    /**
+     * @brief   copy assignment operator
+     */
+    FixedSerialMessage& operator = ( const FixedSerialMessage& other ) {
+                    ByteArray::operator = ( other );
+                    SetPriority( other.GetPriority() );
+                    return *this;
+                }
+
+private:
+    //<! embedded storage
+    uint8_t     _storage[ N ];
 };
 
 #endif // _SerialMessage_H_
@@ -9,12 +9,32 @@
  *          any warranties in the hope that it will be useful.
  */
 
+#include <stdio.h>
 #include "ServiceAccessPoint.h"
-#include "SlipEncoder.h"
+#include "CurrentTime.h"        //getTimeInMs()
 
 
-//<! init static members
-ServiceAccessPoint* ServiceAccessPoint::_First = nullptr;
+//<! default retry policy, a few retries within about a second
+static const ServiceAccessPoint::RetryPolicy    DefaultRetryPolicy = {
+    3,      // MaxRetries
+    50,     // BaseDelay_ms
+    1000,   // MaxDelay_ms
+    8,      // Budget
+    1000    // Refill_ms
+};
+
+
+/**
+ * @brief   xorshift32 pseudo random numbers for the backoff jitter
+ */
+static uint32_t
+jitterRandom( void ) {
+    static uint32_t state = 0x9E3779B9;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
 
 
 /**
@@ -22,15 +42,107 @@ ServiceAccessPoint* ServiceAccessPoint::_First = nullptr;
  *
  * @param   sapID   ID of this service access point
  *
- * @param   port    a serial port
+ * @param   tx          transmit engine of a serial port
+ *
+ * @param   requests    outstanding requests of the radio stack
  */
-ServiceAccessPoint::ServiceAccessPoint( uint8_t sapID, HardwareSerial& port, int numWakeupChars )
+ServiceAccessPoint::ServiceAccessPoint( uint8_t sapID, UartTx& tx, RequestTracker& requests, int numWakeupChars )
                   : _SapID          ( sapID )
-                  , _Port           ( port )
-                  , _NumWakeupChars ( numWakeupChars ) {
-    // add to linked list
-    _Next = _First;
-    _First = this;
+                  , _Tx             ( tx )
+                  , _Requests       ( requests )
+                  , _NumWakeupChars ( numWakeupChars )
+                  , _RetryPolicy    ( DefaultRetryPolicy )
+                  , _RetryTokens    ( DefaultRetryPolicy.Budget )
+                  , _RefillTime     ( getTimeInMs() )
+                  , _RetryStats     () {
+}
+
+
+/**
+ * @brief   set the retry policy, the budget is refilled at once
+ *
+ * @param   policy      retry policy, MaxRetries = 0 disables retries
+ */
+void
+ServiceAccessPoint::SetRetryPolicy( const RetryPolicy& policy ) {
+    _RetryPolicy = policy;
+    _RetryTokens = policy.Budget;
+    _RefillTime  = getTimeInMs();
+}
+
+
+/**
+ * @brief   decide on the retry of a response, called by the request tracker
+ *
+ * @param   status      response status
+ *
+ * @param   attempt     retries so far
+ *
+ * @param   delay_ms    backoff before the re-send
+ *
+ * @return  true if the request is re-sent, false if the response completes it
+ */
+bool
+ServiceAccessPoint::OnRequestTracker_Retry( uint8_t status, uint8_t attempt, uint32_t& delay_ms ) {
+
+    if ( !IsBusyStatus( status ) ) {
+        return false;
+    }
+
+    //lazy budget refill, one token per period since the last refill
+    uint32_t time = getTimeInMs();
+    if ( 0 < _RetryPolicy.Refill_ms ) {
+        uint32_t tokens = ( time - _RefillTime ) / _RetryPolicy.Refill_ms;
+        if ( 0 < tokens ) {
+            _RefillTime += tokens * _RetryPolicy.Refill_ms;
+            _RetryTokens = ( (uint32_t)( _RetryPolicy.Budget - _RetryTokens ) <= tokens ) ? _RetryPolicy.Budget
+                                                                                         : (uint8_t)( _RetryTokens + tokens );
+        }
+    }
+
+    if ( ( attempt >= _RetryPolicy.MaxRetries ) || ( 0 == _RetryTokens ) ) {
+        _RetryStats.Exhausted++;
+        return false;
+    }
+    _RetryTokens--;
+    _RetryStats.Retries++;
+
+    //exponential backoff, half of it random, spreads retries of competing senders
+    uint32_t backoff = _RetryPolicy.MaxDelay_ms;
+    if ( attempt < 16 ) {
+        backoff = (uint32_t)_RetryPolicy.BaseDelay_ms << attempt;
+        if ( backoff > _RetryPolicy.MaxDelay_ms ) {
+            backoff = _RetryPolicy.MaxDelay_ms;
+        }
+    }
+    delay_ms = backoff / 2 + jitterRandom() % ( backoff / 2 + 1 );
+    return true;
+}
+
+
+/**
+ * @brief   re-send a request frame, called by the request tracker after the backoff
+ *
+ * @param   frame       request frame incl. CRC
+ *
+ * @param   priority    transmit priority class
+ *
+ * @return  true if queued
+ */
+bool
+ServiceAccessPoint::OnRequestTracker_Resend( const ByteArrayView& frame, SerialMessage::Priority priority ) {
+    return _Tx.Send( frame, (uint16_t)_NumWakeupChars, nullptr, priority );
+}
+
+
+/**
+ * @brief   prints retry statistics
+ */
+void
+ServiceAccessPoint::printRetryStats( void ) const {
+    printf( "SAP 0x%02X retries: %lu, exhausted %lu, budget %u/%u\r\n",
+        _SapID, (unsigned long)_RetryStats.Retries, (unsigned long)_RetryStats.Exhausted,
+        _RetryTokens, _RetryPolicy.Budget );
 }
 
 
@@ -49,78 +161,93 @@ ServiceAccessPoint::SendMessage( uint8_t reqID ) {
 
 
 /**
- * @brief   send a messsage
+ * @brief   send a messsage, it is SLIP encoded while the UART sends it
  *
  * @param   serialMsg   outgoing message
  *
- * @return  true/false
+ * @param   client      receiver of the completion, optional
+ *
+ * @return  true if queued
  */
 bool
-ServiceAccessPoint::SendMessage( SerialMessage& serialMsg ) {
-
-    ByteArray  outputData;
+ServiceAccessPoint::SendMessage( SerialMessage& serialMsg, UartTx::Client* client ) {
 
     //calculate and append CRCC16
     serialMsg.Append_CRC16();
 
-    //simple solution for systems with enough RAM?
-    //prepend wakeup chars
-    for ( uint8_t i = 0; i < _NumWakeupChars; i++ ) {
-        outputData.append( SlipEncoder::Begin );
-    }
-
-    SlipEncoder::Encode( outputData, serialMsg );
-
-    // encode SLIP frame and forward to port
-    uint16_t output_size = outputData.count();
-    if ( output_size <= _Port.availableForWrite() ) {
-        return ( _Port.write( outputData.data(), (size_t)output_size ) == output_size );
-    }
-    uint16_t offset = 0;
-    //add some TO and SLEEP?
-    while ( offset < output_size ) {
-        uint16_t available = _Port.availableForWrite();
-        if ( available )
-            offset += _Port.write( outputData.data() + offset, (size_t)available );
-    }
-
-    return true;
+    return _Tx.Send( serialMsg, (uint16_t)_NumWakeupChars, client, serialMsg.GetPriority() );
 }
 
 
 /**
- * @brief   check crc and forward message to corresponding service access point
+ * @brief   send a messsage made of header and payload without concatenating them,
+ *          the CRC is calculated across both, the payload is copied onto the wire only
  *
- * @param   serialMsg   incoming message
+ * @param   header      message header, SAP ID, message ID and fixed fields, no CRC
  *
- * @param   result      decoded data in Json fromat
+ * @param   payload     caller-owned payload, must stay valid until completion
  *
- * @return  true/false
+ * @param   client      receiver of the completion, optional
+ *
+ * @return  true if queued
  */
 bool
-ServiceAccessPoint::OnDispatchMessage( SerialMessage& serialMsg, Dictionary& result ) {
-
-    // check CRC first
-    if ( false == serialMsg.CheckCRC16() )
-        return false;
+ServiceAccessPoint::SendMessage( const SerialMessage& header, const ByteArrayView& payload, UartTx::Client* client ) {
+    return _Tx.Send( header, payload, (uint16_t)_NumWakeupChars, client );
+}
 
-    serialMsg.RemoveCRC16();
 
-    ServiceAccessPoint* sap = _First;
+/**
+ * @brief   send a simple request without payload and track its response
+ *
+ * @param   reqID       ID of outgoing request
+ *
+ * @param   rspID       ID of expected response
+ *
+ * @param   client      receiver of response or timeout, optional
+ *
+ * @param   timeout_ms  response timeout
+ *
+ * @return  true/false, false if too many requests are in flight
+ */
+bool
+ServiceAccessPoint::SendRequest( uint8_t reqID, uint8_t rspID, RequestTracker::Client* client, uint32_t timeout_ms ) {
+    SerialMessage   msg( _SapID, reqID );
+    return SendRequest( msg, rspID, client, timeout_ms );
+}
 
-    uint8_t sapID = serialMsg.GetSapID();
 
-    // find SAP
-    while ( sap != nullptr ) {
+/**
+ * @brief   send a request and track its response
+ *
+ * @param   serialMsg   outgoing request
+ *
+ * @param   rspID       ID of expected response
+ *
+ * @param   client      receiver of response or timeout, optional
+ *
+ * @param   timeout_ms  response timeout
+ *
+ * @return  true/false, false if too many requests are in flight or the
+ *          send failed, the client is told Cancelled then
+ *
+ * @note    the frame is kept by the tracker, a busy response re-sends it
+ *          according to the retry policy
+ */
+bool
+ServiceAccessPoint::SendRequest( SerialMessage& serialMsg, uint8_t rspID, RequestTracker::Client* client, uint32_t timeout_ms ) {
 
-        // SAP found ?
-        if ( sap->_SapID == sapID ) {
-            // yes, call message decoder
-            return sap->OnDecodeMessage( serialMsg, result );
-        }
+    //calculate and append CRCC16
+    serialMsg.Append_CRC16();
 
-        // try next one
-        sap = sap->_Next;
+    //track first, the response can not overtake it
+    uint16_t handle = _Requests.Track( _SapID, rspID, client, timeout_ms, this, serialMsg, serialMsg.GetPriority() );
+    if ( RequestTracker::No_Handle == handle ) {
+        return false;
     }
-    return false;
+    if ( !_Tx.Send( serialMsg, (uint16_t)_NumWakeupChars, nullptr, serialMsg.GetPriority() ) ) {
+        _Requests.Cancel( handle );
+        return false;
+    }
+    return true;
 }
@@ -14,42 +14,99 @@
 
 #include "SerialMessage.h"
 #include "Dictionary.h"
-#include "HardwareSerial.h"
+#include "UartTx.h"
+#include "RequestTracker.h"
 
 //#include <QSerialPort>
 
-class ServiceAccessPoint {
+class ServiceAccessPoint : public RequestTracker::Sender {
 
 public:
-                                ServiceAccessPoint( uint8_t sapID, HardwareSerial& port, int numWakeupChars = 0 );
 
-    //<! handle incoming messages
-    static bool                 OnDispatchMessage( SerialMessage& serialMsg, Dictionary& result );
+    //<! retry of requests rejected with a busy status, exponential backoff with jitter
+    struct RetryPolicy {
+        uint8_t                 MaxRetries;     //!< retries per request, 0 disables retries
+        uint16_t                BaseDelay_ms;   //!< backoff of the first retry, doubled per retry
+        uint16_t                MaxDelay_ms;    //!< backoff limit
+        uint8_t                 Budget;         //!< retries in a burst of this SAP
+        uint16_t                Refill_ms;      //!< one retry of the budget is regained per period
+    };
+
+    //<! retry statistics
+    struct RetryStats {
+        uint32_t                Retries;        //!< requests re-sent
+        uint32_t                Exhausted;      //!< busy responses passed on, retries or budget used up
+    };
+
+                                ServiceAccessPoint( uint8_t sapID, UartTx& tx, RequestTracker& requests, int numWakeupChars = 0 );
+
+    //<! SAP identifier
+    uint8_t                     GetSapID( void ) const { return _SapID; }
+
+    //<! retry policy, the budget is refilled at once
+    void                        SetRetryPolicy( const RetryPolicy& policy );
+    const RetryPolicy&          GetRetryPolicy( void ) const { return _RetryPolicy; }
+
+    //<! retry statistics
+    const RetryStats&           GetRetryStats( void ) const { return _RetryStats; }
+    void                        printRetryStats( void ) const;
 
 protected:
 
-    //<! helpers for outgoing messages
+    //<! helpers for outgoing messages, queued for the transmit engine in the priority class
+    //<! of the message, they do not wait for the UART
     bool                        SendMessage( uint8_t reqID );
-    bool                        SendMessage( SerialMessage& serialMsg );
+    bool                        SendMessage( SerialMessage& serialMsg, UartTx::Client* client = nullptr );
+
+    //<! header and caller-owned payload, payload must stay valid until the client sees completion
+    bool                        SendMessage( const SerialMessage& header, const ByteArrayView& payload,
+                                             UartTx::Client* client = nullptr );
 
-    virtual bool                OnDecodeMessage( const SerialMessage& /* serialMsg */, Dictionary& /* result */ ) { return false; }
+    //<! helpers for outgoing requests, the response or timeout completes them at the client
+    bool                        SendRequest( uint8_t reqID, uint8_t rspID, RequestTracker::Client* client,
+                                             uint32_t timeout_ms = RequestTracker::Default_Timeout );
+    bool                        SendRequest( SerialMessage& serialMsg, uint8_t rspID, RequestTracker::Client* client,
+                                             uint32_t timeout_ms = RequestTracker::Default_Timeout );
+
+    //<! decoder of incoming messages, typed events go to the client of the SAP,
+    //<! text is formatted into result only if it is not nullptr
+    virtual bool                OnDecodeMessage( const SerialMessage& /* serialMsg */, Dictionary* /* result */ ) { return false; }
+
+    //<! response status meaning the request was not processed and may be re-sent later
+    virtual bool                IsBusyStatus( uint8_t /* status */ ) const { return false; }
+
+    //<! retry policy of the request tracker
+    bool                        OnRequestTracker_Retry( uint8_t status, uint8_t attempt, uint32_t& delay_ms ) override;
+    bool                        OnRequestTracker_Resend( const ByteArrayView& frame, SerialMessage::Priority priority ) override;
+
+    //<! incoming messages are passed to OnDecodeMessage by the dispatcher of the radio stack
+    friend class                SapDispatcher;
 
 protected:
 
     //<! SAP identifier
     uint8_t                     _SapID;
 
-    //<! SerialPort used from Qt
-    HardwareSerial&             _Port;
+    //<! transmit engine of the serial port
+    UartTx&                     _Tx;
+
+    //<! outstanding requests of the radio stack
+    RequestTracker&             _Requests;
 
     //<! wakeup chars for sleeping, power saving end nodes
     int                         _NumWakeupChars;
 
-    //<! linked list for ServiceAccessPoints
-    ServiceAccessPoint*         _Next;
+    //<! retry policy
+    RetryPolicy                 _RetryPolicy;
+
+    //<! retries left in the budget
+    uint8_t                     _RetryTokens;
+
+    //<! time stamp of the last budget refill
+    uint32_t                    _RefillTime;
 
-    //<! first registered ServiceAccessPoint
-    static ServiceAccessPoint*  _First;
+    //<! retry statistics
+    RetryStats                  _RetryStats;
 };
 
 #endif // _ServiceAccessPoint_H_
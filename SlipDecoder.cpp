@@ -12,8 +12,15 @@
  * Gatis Gaigals @ EDI, 2024 
  */
 
+#include <cstring>
 #include "SlipDecoder.h"
 
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+#include <arm_neon.h>
+#endif
+
 /**
  * @brief       class contructor
  *
@@ -21,7 +28,13 @@
  */
 SlipDecoder::SlipDecoder( SlipDecoder::Client* client )
            : _DecoderClient( client )
-           , _State( SlipDecoder::Initial ) {
+           , _State( SlipDecoder::Initial )
+           , _Output( nullptr )
+           , _CRC( CRC16::Init_Value )
+           , _Frames( 0 )
+           , _CrcErrors( 0 )
+           , _Overflow( false )
+           , _Overflows( 0 ) {
 }
 
 /**
@@ -31,67 +44,259 @@ SlipDecoder::SlipDecoder( SlipDecoder::Client* client )
 void
 SlipDecoder::Reset() {
     _State = SlipDecoder::Initial;
+    _CRC = CRC16::Init_Value;
+    _Overflow = false;
 }
 
 /**
- * @brief   decode SLIP stream
+ * @brief   start a new frame
+ */
+
+void
+SlipDecoder::beginFrame( void ) {
+    // reset output buffer
+    _Output->clear();
+    _CRC = CRC16::Init_Value;
+    _Overflow = false;
+}
+
+/**
+ * @brief   append a run of decoded bytes to the frame and update running CRC
  *
- * @param   output      decoded data
+ * @param   pdata       decoded bytes
+ * @param   n           number of bytes
+ */
+
+void
+SlipDecoder::appendRun( const uint8_t* pdata, uint32_t n ) {
+    uint16_t before = _Output->count();
+    if ( ( n > (uint32_t)( ByteArray::Max_Size - before ) )
+      || ( _Output->append( pdata, (uint16_t)n ).count() == before ) ) {
+        // frame does not fit, it is reported as broken at its end
+        _Overflow = true;
+    }
+    _CRC = CRC16::Update( _CRC, pdata, n );
+}
+
+/**
+ * @brief   complete a frame, the frame check sequence is verified
+ *          without a second pass over the frame, the client may rebind
+ *          the output before the next frame starts
+ */
+
+void
+SlipDecoder::endFrame( void ) {
+    if ( ( _Output->count() > 0 ) || _Overflow ) {
+        bool crcValid = !_Overflow && ( CRC16::Good_Value == (uint16_t)~_CRC );
+        _Frames++;
+        if ( _Overflow ) {
+            _Overflows++;
+        } else if ( !crcValid ) {
+            _CrcErrors++;
+        }
+        // notify client that SLIP frame is ready in output buffer
+        if ( _DecoderClient ) {
+            _DecoderClient->OnSlipDecoder_MessageReady( *_Output, crcValid );
+        }
+    }
+    // reset output buffer
+    beginFrame();
+}
+
+/**
+ * @brief   returns pointer to the next End or Esc character
  *
- * @param   input       incoming SLIP encoded data
+ * @param   pdata       first byte to check
+ * @param   plimit      end of data
  *
- * @note    _Client->OnSlipDecoder_MessageReady is called with decoded SLIP message
+ * @return  pointer to End or Esc, plimit if none found
+ *
+ * @note    16 bytes per step with SSE2/NEON on host builds,
+ *          4 bytes per step with SWAR (bit tricks in a register) elsewhere
+ */
+
+const uint8_t*
+SlipDecoder::FindSpecial( const uint8_t* pdata, const uint8_t* plimit ) {
+
+#if defined( __SSE2__ )
+    const __m128i end = _mm_set1_epi8( (char)SlipDecoder::End );
+    const __m128i esc = _mm_set1_epi8( (char)SlipDecoder::Esc );
+    while ( ( plimit - pdata ) >= 16 ) {
+        __m128i bytes = _mm_loadu_si128( (const __m128i*)pdata );
+        int mask = _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( bytes, end ), _mm_cmpeq_epi8( bytes, esc ) ) );
+        if ( mask ) {
+            return pdata + __builtin_ctz( (unsigned)mask );
+        }
+        pdata += 16;
+    }
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+    const uint8x16_t end = vdupq_n_u8( SlipDecoder::End );
+    const uint8x16_t esc = vdupq_n_u8( SlipDecoder::Esc );
+    while ( ( plimit - pdata ) >= 16 ) {
+        uint8x16_t bytes = vld1q_u8( pdata );
+        if ( vmaxvq_u8( vorrq_u8( vceqq_u8( bytes, end ), vceqq_u8( bytes, esc ) ) ) ) {
+            break;
+        }
+        pdata += 16;
+    }
+#else
+    // a byte of x is zero <=> ( x - 0x01.. ) & ~x & 0x80.. has its top bit set
+    const uint32_t ones = 0x01010101u;
+    const uint32_t high = 0x80808080u;
+    const uint32_t end  = ones * SlipDecoder::End;
+    const uint32_t esc  = ones * SlipDecoder::Esc;
+    while ( ( plimit - pdata ) >= 4 ) {
+        uint32_t word;
+        std::memcpy( &word, pdata, sizeof( word ) );
+        uint32_t xend = word ^ end;
+        uint32_t xesc = word ^ esc;
+        if ( ( ( ( xend - ones ) & ~xend ) | ( ( xesc - ones ) & ~xesc ) ) & high ) {
+            break;
+        }
+        pdata += 4;
+    }
+#endif
+
+    while ( pdata < plimit ) {
+        if ( ( SlipDecoder::End == *pdata ) || ( SlipDecoder::Esc == *pdata ) ) {
+            break;
+        }
+        pdata++;
+    }
+    return pdata;
+}
+
+/**
+ * @brief   returns number of End and Esc characters
+ *
+ * @param   pdata       first byte to check
+ * @param   plimit      end of data
+ *
+ * @return  number of End and Esc characters
+ *
+ * @note    16 bytes per step with SSE2/NEON on host builds,
+ *          4 bytes per step with SWAR elsewhere, no branch per character
+ */
+
+uint32_t
+SlipDecoder::CountSpecial( const uint8_t* pdata, const uint8_t* plimit ) {
+
+    uint32_t count = 0;
+
+#if defined( __SSE2__ )
+    const __m128i end = _mm_set1_epi8( (char)SlipDecoder::End );
+    const __m128i esc = _mm_set1_epi8( (char)SlipDecoder::Esc );
+    while ( ( plimit - pdata ) >= 16 ) {
+        __m128i bytes = _mm_loadu_si128( (const __m128i*)pdata );
+        int mask = _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( bytes, end ), _mm_cmpeq_epi8( bytes, esc ) ) );
+        count += (uint32_t)__builtin_popcount( (unsigned)mask );
+        pdata += 16;
+    }
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+    const uint8x16_t end = vdupq_n_u8( SlipDecoder::End );
+    const uint8x16_t esc = vdupq_n_u8( SlipDecoder::Esc );
+    while ( ( plimit - pdata ) >= 16 ) {
+        uint8x16_t bytes = vld1q_u8( pdata );
+        count += vaddvq_u8( vshrq_n_u8( vorrq_u8( vceqq_u8( bytes, end ), vceqq_u8( bytes, esc ) ), 7 ) );
+        pdata += 16;
+    }
+#else
+    // exact zero byte flags: top bit of a byte is set <=> the byte of x is zero
+    const uint32_t ones = 0x01010101u;
+    const uint32_t low  = 0x7F7F7F7Fu;
+    const uint32_t end  = ones * SlipDecoder::End;
+    const uint32_t esc  = ones * SlipDecoder::Esc;
+    while ( ( plimit - pdata ) >= 4 ) {
+        uint32_t word;
+        std::memcpy( &word, pdata, sizeof( word ) );
+        uint32_t xend = word ^ end;
+        uint32_t xesc = word ^ esc;
+        uint32_t zend = ~( ( ( xend & low ) + low ) | xend | low );
+        uint32_t zesc = ~( ( ( xesc & low ) + low ) | xesc | low );
+        // End and Esc differ, so at most one flag per byte, sum the flags
+        count += ( ( ( zend | zesc ) >> 7 ) * ones ) >> 24;
+        pdata += 4;
+    }
+#endif
+
+    while ( pdata < plimit ) {
+        count += ( SlipDecoder::End == *pdata ) | ( SlipDecoder::Esc == *pdata );
+        pdata++;
+    }
+    return count;
+}
+
+/**
+ * @brief   decode a chunk of the encoded SLIP stream into the bound output
+ *
+ * @param   input       incoming SLIP encoded data
+ * @param   n           number of bytes
  *
+ * @note    _Client->OnSlipDecoder_MessageReady is called with decoded SLIP message,
+ *          the state machine runs only at special characters, clean runs are
+ *          appended and CRC'd in one piece
  */
 void
-SlipDecoder::Decode( ByteArray& output, const ByteArray& input ) {
+SlipDecoder::Decode( const uint8_t* input, uint32_t n ) {
 
-    for ( int index = 0; index < input.count(); index++ ) {
+    if ( nullptr == _Output ) {
+        return;
+    }
+
+    const uint8_t*  pdata   = input;
+    const uint8_t*  plimit  = input + n;
 
-        uint8_t byte = (uint8_t)input.at( index );
+    while ( pdata < plimit ) {
 
         switch ( _State ) {
         case SlipDecoder::Initial:
 
-            // begin of SLIP frame ?
-            if ( SlipDecoder::Begin == byte ) {
-                // reset output buffer
-                output.clear();
-                _State = SlipDecoder::InFrame;
+            // skip to begin of SLIP frame
+            pdata = (const uint8_t*)std::memchr( pdata, SlipDecoder::Begin, plimit - pdata );
+            if ( nullptr == pdata ) {
+                return;
             }
+            pdata++;
+            beginFrame();
+            _State = SlipDecoder::InFrame;
             break;
 
-        case SlipDecoder::InFrame:
+        case SlipDecoder::InFrame: {
 
-            // end of SLIP frame ?
-            if ( SlipDecoder::End == byte ) {
-                // notify client that SLIP frame is ready in output buffer
-                if ( _DecoderClient && ( output.count() > 0 ) ) {
-                    _DecoderClient->OnSlipDecoder_MessageReady( output );
+            // copy clean run up to next special character
+            const uint8_t* pspecial = FindSpecial( pdata, plimit );
+            if ( pspecial > pdata ) {
+                appendRun( pdata, pspecial - pdata );
+                pdata = pspecial;
+                if ( pdata == plimit ) {
+                    return;
                 }
-                // reset output buffer
-                output.clear();
             }
-            // SLIP esc ?
-            else if ( SlipDecoder::Esc == byte ) {
-                _State = SlipDecoder::EscState;
+
+            // end of SLIP frame ?
+            if ( SlipDecoder::End == *pdata++ ) {
+                // notify client, reset output buffer
+                endFrame();
             }
-            // default case
+            // SLIP esc
             else {
-                output.append( byte );
+                _State = SlipDecoder::EscState;
             }
             break;
+        }
+
+        case SlipDecoder::EscState: {
 
-        case  SlipDecoder::EscState:
+            uint8_t byte = *pdata++;
 
             // end of escape state ?
             if ( SlipDecoder::EscEnd == byte ) {
-                output.append( SlipDecoder::End );
-                _State = InFrame;
+                appendByte( SlipDecoder::End );
+                _State = SlipDecoder::InFrame;
             }
             // end of escape state ?
             else if ( SlipDecoder::EscEsc == byte ) {
-                output.append( SlipDecoder::Esc );
+                appendByte( SlipDecoder::Esc );
                 _State = SlipDecoder::InFrame;
             }
             // error
@@ -100,10 +305,39 @@ SlipDecoder::Decode( ByteArray& output, const ByteArray& input ) {
                 _State = SlipDecoder::Initial;
             }
             break;
+        }
 
         } // switch ( _State )
 
-    } // for...
+    } // while...
+}
+
+/**
+ * @brief   decode a chunk of the encoded SLIP stream
+ *
+ * @param   output      decoded data, becomes the bound output
+ * @param   input       incoming SLIP encoded data
+ * @param   n           number of bytes
+ */
+void
+SlipDecoder::Decode( ByteArray& output, const uint8_t* input, uint32_t n ) {
+    _Output = &output;
+    Decode( input, n );
+}
+
+/**
+ * @brief   decode SLIP stream
+ *
+ * @param   output      decoded data
+ *
+ * @param   input       incoming SLIP encoded data
+ *
+ * @note    _Client->OnSlipDecoder_MessageReady is called with decoded SLIP message
+ *
+ */
+void
+SlipDecoder::Decode( ByteArray& output, const ByteArrayView& input ) {
+    Decode( output, input.data(), input.count() );
 }
 
 /**
@@ -118,62 +352,8 @@ void
 SlipDecoder::Decode( ByteArray& output, int input ) {
 
     if ( -1 < input ) {
-
         uint8_t byte = (uint8_t)input;
-
-        switch ( _State ) {
-        case SlipDecoder::Initial:
-
-            //begin of SLIP frame ?
-            if ( SlipDecoder::Begin == byte ) {
-                // reset output buffer
-                output.clear();
-                _State = SlipDecoder::InFrame;
-            }
-            break;
-
-        case SlipDecoder::InFrame:
-
-            //end of SLIP frame ?
-            if ( SlipDecoder::End == byte ) {
-                //notify client that SLIP frame is ready in output buffer
-                if ( _DecoderClient && ( output.count() > 0 ) ) {
-                    _DecoderClient->OnSlipDecoder_MessageReady( output );
-                }
-                //reset output buffer
-                output.clear();
-            }
-            //SLIP esc ?
-            else if ( SlipDecoder::Esc == byte ) {
-                _State = SlipDecoder::EscState;
-            }
-            //default case
-            else {
-                output.append( byte );
-            }
-            break;
-
-        case  SlipDecoder::EscState:
-
-            //end of escape state ?
-            if ( SlipDecoder::EscEnd == byte ) {
-                output.append( SlipDecoder::End );
-                _State = InFrame;
-            }
-            //end of escape state ?
-            else if ( SlipDecoder::EscEsc == byte ) {
-                output.append( SlipDecoder::Esc );
-                _State = SlipDecoder::InFrame;
-            }
-            //error
-            else {
-                //abort frame reception -> return to initial state
-                _State = SlipDecoder::Initial;
-            }
-            break;
-
-        } //switch ( _State )
-
+        Decode( output, &byte, 1 );
     }
 }
 
@@ -183,69 +363,23 @@ SlipDecoder::Decode( ByteArray& output, int input ) {
  * @param   output          decoded frame
  * @param   flByteStream    function returning a byte/-1 from the encoded SLIP byte stream
  *
- * @note    on signal "OnFrameReady" the decoded SLIP frame is ready the output array
+ * @note    on signal "OnFrameReady" the decoded SLIP frame is ready the output array,
+ *          bytes are collected in chunks and passed to the bulk decoder
  */
 void
 SlipDecoder::Decode( ByteArray& output, int (*const flByteStream)( void ) ) {
 
-    int input;
-
-    while ( -1 < ( input = flByteStream() ) ) {
+    uint8_t     chunk[ Chunk_Size ];
+    uint32_t    n;
+    int         input = 0;
 
-        uint8_t byte = (uint8_t)input;
-
-        switch ( _State ) {
-        case SlipDecoder::Initial:
-
-            //begin of SLIP frame ?
-            if ( SlipDecoder::Begin == byte ) {
-                //reset output buffer
-                output.clear();
-                _State = SlipDecoder::InFrame;
+    while ( -1 < input ) {
+        for ( n = 0; n < sizeof( chunk ); n++ ) {
+            if ( 0 > ( input = flByteStream() ) ) {
+                break;
             }
-            break;
-
-        case SlipDecoder::InFrame:
-
-            //end of SLIP frame ?
-            if ( SlipDecoder::End == byte ) {
-                //notify client that SLIP frame is ready in output buffer
-                if ( _DecoderClient && ( output.count() > 0 ) ) {
-                    _DecoderClient->OnSlipDecoder_MessageReady( output );
-                }
-                //reset output buffer
-                output.clear();
-            }
-            //SLIP esc ?
-            else if ( SlipDecoder::Esc == byte ) {
-                _State = SlipDecoder::EscState;
-            }
-            // default case
-            else {
-                output.append( byte );
-            }
-            break;
-
-        case  SlipDecoder::EscState:
-
-            //end of escape state ?
-            if ( SlipDecoder::EscEnd == byte ) {
-                output.append( SlipDecoder::End );
-                _State = InFrame;
-            }
-            //end of escape state ?
-            else if ( SlipDecoder::EscEsc == byte ) {
-                output.append( SlipDecoder::Esc );
-                _State = SlipDecoder::InFrame;
-            }
-            //error
-            else {
-                //abort frame reception -> return to initial state
-                _State = SlipDecoder::Initial;
-            }
-            break;
-
-        } //switch( _State )
-
-    } //while...
+            chunk[n] = (uint8_t)input;
+        }
+        Decode( output, chunk, n );
+    }
 }
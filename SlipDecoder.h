@@ -16,6 +16,7 @@
 #define _Slip_Decoder_H_
 
 #include "ByteArray.h"
+#include "CRC16.h"
 
 /**
  * @brief   The SlipDecoder class decodes SLIP encoded byte streams.
@@ -32,8 +33,8 @@ public:
     class Client {
 
     public:
-        //<! handler for received SLIP messages
-        virtual void OnSlipDecoder_MessageReady( const ByteArray& /* message */ ) { }
+        //<! handler for received SLIP messages, crcValid is the X.25 check over the whole frame
+        virtual void OnSlipDecoder_MessageReady( const ByteArray& /* message */, bool /* crcValid */ ) { }
     };
 
 
@@ -47,6 +48,36 @@ public:
      */
     void        Reset();
 
+    /**
+     * @brief   bind output array for decoded frames, may be called from
+     *          OnSlipDecoder_MessageReady to hand over the completed frame
+     *
+     * @param   output      array for the next decoded frame
+     */
+    void        SetOutput( ByteArray& output ) { _Output = &output; }
+
+    /**
+     * @brief   decode a chunk of the encoded SLIP stream into the bound output,
+     *          runs between special characters are copied in one piece
+     *
+     * @param   input       SLIP encoded bytes
+     * @param   n           number of bytes
+     *
+     * @note    on signal "OnFrameReady" the decoded SLIP frame is ready the output array
+     */
+    void        Decode( const uint8_t* input, uint32_t n );
+
+    /**
+     * @brief   decode a chunk of the encoded SLIP stream
+     *
+     * @param   output      decoded frame, becomes the bound output
+     * @param   input       SLIP encoded bytes
+     * @param   n           number of bytes
+     *
+     * @note    on signal "OnFrameReady" the decoded SLIP frame is ready the output array
+     */
+    void        Decode( ByteArray& output, const uint8_t* input, uint32_t n );
+
     /**
      * @brief   decode encoded SLIP stream
      *
@@ -55,7 +86,7 @@ public:
      *
      * @note    on signal "OnFrameReady" the decoded SLIP frame is ready the output array
      */
-    void        Decode( ByteArray& output, const ByteArray& input );
+    void        Decode( ByteArray& output, const ByteArrayView& input );
 
     /**
      * @brief   decode a byte from the encoded SLIP stream
@@ -77,8 +108,59 @@ public:
      */
     void        Decode( ByteArray& output, int (*const flByteStream)( void ) );
 
+    /**
+     * @return  number of decoded frames
+     */
+    uint32_t    GetFrames( void ) const { return _Frames; }
+
+    /**
+     * @return  number of decoded frames with CRC error
+     */
+    uint32_t    GetCrcErrors( void ) const { return _CrcErrors; }
+
+    /**
+     * @return  number of frames which did not fit into the output array
+     */
+    uint32_t    GetOverflows( void ) const { return _Overflows; }
+
+    /**
+     * @brief   returns pointer to the next End or Esc character, plimit if none,
+     *          shared with SlipEncoder, both escape the same characters
+     */
+    static const uint8_t*   FindSpecial( const uint8_t* pdata, const uint8_t* plimit );
+
+    /**
+     * @brief   returns number of End and Esc characters, equal speed for any content
+     */
+    static uint32_t         CountSpecial( const uint8_t* pdata, const uint8_t* plimit );
+
 private:
 
+    enum {
+        //<! chunk size for reading a byte stream callback
+        Chunk_Size  =   32
+    };
+
+    /**
+     * @brief   append a run of decoded bytes to the frame and update running CRC
+     */
+    void        appendRun( const uint8_t* pdata, uint32_t n );
+
+    /**
+     * @brief   start a new frame
+     */
+    void        beginFrame( void );
+
+    /**
+     * @brief   append a decoded byte to the frame and update running CRC
+     */
+    void        appendByte( uint8_t byte ) { appendRun( &byte, 1 ); }
+
+    /**
+     * @brief   complete a frame, notify client
+     */
+    void        endFrame( void );
+
     /**
      * standard SLIP frame characters
      */
@@ -106,6 +188,24 @@ private:
 
     //<! decoder state
     DecoderState            _State;
+
+    //<! output array for decoded frame
+    ByteArray*              _Output;
+
+    //<! running CRC16 over decoded bytes of current frame
+    uint16_t                _CRC;
+
+    //<! decoded frames
+    uint32_t                _Frames;
+
+    //<! decoded frames with CRC error
+    uint32_t                _CrcErrors;
+
+    //<! current frame did not fit into the output array
+    bool                    _Overflow;
+
+    //<! frames which did not fit into the output array
+    uint32_t                _Overflows;
 };
 
 #endif // _Slip_Decoder_H_
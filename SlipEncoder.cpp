@@ -12,9 +12,9 @@
  * Gatis Gaigals @ EDI, 2024 
  */
 
+#include <cstring>
 #include "SlipEncoder.h"
-
-#ifdef SlipEncoder_BufferLess_Version
+#include "SlipDecoder.h"
 
 /**
  * @brief   class constructor
@@ -22,7 +22,9 @@
 
 SlipEncoder::SlipEncoder()
            : _State         ( SlipEncoder::Idle )
-           , _Input         ( nullptr )
+           , _NumSegments   ( 0 )
+           , _Segment       ( 0 )
+           , _Input         ()
            , _Index         ( 0 )
            , _NumWakeupChars( 0 )
 
@@ -38,11 +40,38 @@ SlipEncoder::SlipEncoder()
  */
 
 bool
-SlipEncoder::SetInput( const ByteArray* input, uint16_t numWakeupChars )
+SlipEncoder::SetInput( const ByteArrayView& input, uint16_t numWakeupChars )
 {
-    if ( ( _State == SlipEncoder::Idle ) && ( input != nullptr ) )
+    return SetInput( &input, 1, numWakeupChars );
+}
+
+/**
+ * @brief   prepare encoder for SLIP message made of segments
+ *
+ * @param   segments            segments in frame order, the views are copied,
+ *                              the viewed data must stay valid until completion
+ * @param   numSegments         number of segments, 1..Max_Segments
+ * @param   numWakeupChars      optional number of wakeup chars which
+ *                              should be transmitted first
+ */
+
+bool
+SlipEncoder::SetInput( const ByteArrayView segments[], uint8_t numSegments, uint16_t numWakeupChars )
+{
+    if ( ( 0 == numSegments ) || ( numSegments > SlipEncoder::Max_Segments ) )
+    {
+        return false;
+    }
+
+    if ( _State == SlipEncoder::Idle )
     {
-        _Input          = input;
+        for ( uint8_t i = 0; i < numSegments; i++ )
+        {
+            _Segments[ i ] = segments[ i ];
+        }
+        _NumSegments    = numSegments;
+        _Segment        = 0;
+        _Input          = _Segments[ 0 ];
         _Index          = 0;
         _NumWakeupChars = numWakeupChars;
 
@@ -112,16 +141,22 @@ SlipEncoder::GetEncodedByte()
         // normal coding
         case    SlipEncoder::InFrame:
             {
-                // eof ?
-                if ( _Input->count() <= _Index )
+                // end of segment --> continue with next one
+                while ( _Input.count() <= _Index )
                 {
-                    // end of frame --> send terminating SLIP_END
-                    _State = SlipEncoder::WaitForCompletion;
-                    return SlipEncoder::End;
+                    // eof ?
+                    if ( ( _Segment + 1 ) >= _NumSegments )
+                    {
+                        // end of frame --> send terminating SLIP_END
+                        _State = SlipEncoder::WaitForCompletion;
+                        return SlipEncoder::End;
+                    }
+                    _Input = _Segments[ ++_Segment ];
+                    _Index = 0;
                 }
 
                 // get next txByte
-                uint8_t txByte = _Input->at( _Index++ );
+                uint8_t txByte = _Input[ _Index++ ];
 
                 // special character --> send SLIP_ESC
                 if ( txByte == SlipEncoder::End )
@@ -158,51 +193,150 @@ SlipEncoder::OnCompleteIndication()
 {
     if ( _State == SlipEncoder::EndState )
     {
-        _Input = nullptr;
-        _Index = 0;
+        _Input       = ByteArrayView();
+        _Index       = 0;
+        _NumSegments = 0;
+        _Segment     = 0;
         _State = Idle;
     }
 }
 
-#else
+/**
+ * @brief   return a chunk of SLIP encoded bytes
+ *
+ * @param   output      buffer for encoded bytes
+ * @param   size        max bytes to return
+ *
+ * @return  number of bytes, less than size if the last byte has been encoded
+ */
+
+uint16_t
+SlipEncoder::GetEncodedBytes( uint8_t* output, uint16_t size )
+{
+    uint16_t count = 0;
+
+    while ( count < size )
+    {
+        int16_t txByte = GetEncodedByte();
+
+        if ( 0 > txByte )
+        {
+            break;
+        }
+        output[ count++ ] = (uint8_t)txByte;
+    }
+    return count;
+}
+
+/**
+ * @brief   abort current message, encoder is idle afterwards
+ */
+
+void
+SlipEncoder::Reset()
+{
+    _Input          = ByteArrayView();
+    _Index          = 0;
+    _NumSegments    = 0;
+    _Segment        = 0;
+    _NumWakeupChars = 0;
+    _State          = SlipEncoder::Idle;
+}
+
+/**
+ * @brief   returns exact size of the SLIP frame
+ *
+ * @param   segments    segments in frame order
+ *
+ * @param   numSegments number of segments
+ *
+ * @return  End + escaped segments + End
+ */
+uint32_t
+SlipEncoder::EncodedSize( const ByteArrayView segments[], uint8_t numSegments )
+{
+    uint32_t size = 2;
+
+    for ( uint8_t i = 0; i < numSegments; i++ )
+    {
+        const uint8_t*  pdata   = segments[ i ].data();
+        const uint8_t*  plimit  = pdata + segments[ i ].count();
+
+        // every End or Esc takes one more byte
+        size += segments[ i ].count() + SlipDecoder::CountSpecial( pdata, plimit );
+    }
+    return size;
+}
+
 /**
  * @brief   encode message
  *
- * @param   output      buffer for encoded message
+ * @param   output      buffer for encoded message, frame is appended
  *
  * @param   input       buffer with original messsage
  *
- * @return  reference to output buffer
+ * @return  true/false, false if the frame does not fit
+ */
+bool
+SlipEncoder::Encode( ByteArray& output, const ByteArrayView& input )
+{
+    return Encode( output, &input, 1 );
+}
+
+/**
+ * @brief   encode segments as one frame, the output is sized exactly once
+ *          and clean runs between special characters are copied in one piece
+ *
+ * @param   output      buffer for encoded message, frame is appended
+ *
+ * @param   segments    segments in frame order
+ *
+ * @param   numSegments number of segments
+ *
+ * @return  true/false, false if the frame does not fit, output is unchanged
  */
-ByteArray&
-SlipEncoder::Encode( ByteArray& output, const ByteArray& input )
+bool
+SlipEncoder::Encode( ByteArray& output, const ByteArrayView segments[], uint8_t numSegments )
 {
-    output.append( SlipEncoder::End );
+    uint32_t count = (uint32_t)output.count() + EncodedSize( segments, numSegments );
 
-    for ( int index = 0; index < input.count(); index++ )
+    // never a truncated frame
+    if ( !output.reserve( count ) )
     {
-        uint8_t byte = (uint8_t)input.at( index );
+        return false;
+    }
 
-        switch ( byte )
+    uint8_t* pout = output.data() + output.count();
+
+    *pout++ = SlipEncoder::End;
+
+    for ( uint8_t i = 0; i < numSegments; i++ )
+    {
+        const uint8_t*  pdata   = segments[ i ].data();
+        const uint8_t*  plimit  = pdata + segments[ i ].count();
+
+        while ( pdata < plimit )
         {
-            case  SlipEncoder::End:
-                    output.append( SlipEncoder::Esc );
-                    output.append( SlipEncoder::EscEnd );
-                    break;
-
-            case  SlipEncoder::Esc:
-                    output.append( SlipEncoder::Esc );
-                    output.append( SlipEncoder::EscEsc );
-                    break;
-
-            default:
-                    output.append( byte );
-                    break;
+            // escape, no search for back to back special characters
+            if ( ( SlipEncoder::End == *pdata ) || ( SlipEncoder::Esc == *pdata ) )
+            {
+                *pout++ = SlipEncoder::Esc;
+                *pout++ = ( SlipEncoder::End == *pdata ) ? SlipEncoder::EscEnd : SlipEncoder::EscEsc;
+                pdata++;
+                continue;
+            }
+
+            // clean run up to the next special character
+            const uint8_t* pspecial = SlipDecoder::FindSpecial( pdata + 1, plimit );
+
+            std::memcpy( pout, pdata, pspecial - pdata );
+            pout += pspecial - pdata;
+            pdata = pspecial;
         }
     }
 
-    output.append( SlipEncoder::End );
+    *pout++ = SlipEncoder::End;
 
-    return output;
+    output.update_count( (uint16_t)count );
+    return true;
 }
-#endif
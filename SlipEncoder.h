@@ -17,10 +17,15 @@
 
 #include "ByteArray.h"
 
-//#define SlipEncoder_BufferLess_Version
-
 /**
  * @brief   The SlipEncoder class encodes a byte stream into a SLIP encoded byte stream
+ *
+ *          - Encode()          whole frame into a buffer at once
+ *          - GetEncodedByte()  state machine, a frame is encoded while it is sent
+ *                              (bufferless version, e.g. UART TX interrupt or UartTx)
+ *
+ *          Both accept a list of segments (e.g. HCI header, caller-owned payload, CRC),
+ *          which are encoded as one frame without concatenating them first.
  */
 
 class SlipEncoder
@@ -39,7 +44,12 @@ public:
         EscEsc  =   0xDD
     };
 
-#ifdef  SlipEncoder_BufferLess_Version
+    enum
+    {
+        //<! max segments of a frame
+        Max_Segments    =   4
+    };
+
     /**
      * @brief   class constructor
      */
@@ -53,7 +63,19 @@ public:
      *                              should be transmitted first
      */
 
-    bool                    SetInput( const ByteArray* input, uint16_t numWakeupChars = 0 );
+    bool                    SetInput( const ByteArrayView& input, uint16_t numWakeupChars = 0 );
+
+    /**
+     * @brief   prepare encoder for SLIP message made of segments
+     *
+     * @param   segments            segments in frame order, the views are copied,
+     *                              the viewed data must stay valid until completion
+     * @param   numSegments         number of segments, 1..Max_Segments
+     * @param   numWakeupChars      optional number of wakeup chars which
+     *                              should be transmitted first
+     */
+
+    bool                    SetInput( const ByteArrayView segments[], uint8_t numSegments, uint16_t numWakeupChars = 0 );
 
     /**
      * @brief   return a single SLIP encoded byte
@@ -74,24 +96,67 @@ public:
 
     void                    OnCompleteIndication();
 
-#else
+    /**
+     * @brief   return a chunk of SLIP encoded bytes
+     *
+     * @param   output      buffer for encoded bytes
+     * @param   size        max bytes to return
+     *
+     * @return  number of bytes, less than size if the last byte has been encoded
+     */
+
+    uint16_t                GetEncodedBytes( uint8_t* output, uint16_t size );
+
+    /**
+     * @brief   abort current message, encoder is idle afterwards
+     */
+
+    void                    Reset();
+
+    /**
+     * @return  true if no message is being encoded
+     */
+
+    bool                    IsIdle() const { return ( _State == SlipEncoder::Idle ); }
+
+    /**
+     * @brief   returns exact size of the SLIP frame, End + escaped segments + End
+     *
+     * @param   segments    segments in frame order
+     * @param   numSegments number of segments
+     *
+     * @return  encoded size in bytes
+     */
+
+    static uint32_t         EncodedSize( const ByteArrayView segments[], uint8_t numSegments );
 
     /**
      * @brief   encode byte stream ( this version is only recommended if RAM is not an expensive resource )
      *
-     * @param   output      encoded SLIP stream
+     * @param   output      encoded SLIP stream is appended
      * @param   input       bytes to encode
      *
-     * @return  output      updated output buffer with SLIP encoded byte stream
+     * @return  true  - frame appended
+     *          false - frame does not fit into output, output is unchanged
      */
 
-    static ByteArray&      Encode( ByteArray& output, const ByteArray& input );
+    static bool             Encode( ByteArray& output, const ByteArrayView& input );
+
+    /**
+     * @brief   encode segments as one frame
+     *
+     * @param   output      encoded SLIP stream is appended
+     * @param   segments    segments in frame order
+     * @param   numSegments number of segments
+     *
+     * @return  true  - frame appended
+     *          false - frame does not fit into output, output is unchanged
+     */
 
-#endif
+    static bool             Encode( ByteArray& output, const ByteArrayView segments[], uint8_t numSegments );
 
 private:
 
-#ifdef  SlipEncoder_BufferLess_Version
     enum EncoderState
     {
         Idle    =   0,
@@ -105,10 +170,12 @@ private:
     };
 
     EncoderState            _State;
-    const ByteArray*        _Input;
+    ByteArrayView           _Segments[ Max_Segments ];
+    uint8_t                 _NumSegments;
+    uint8_t                 _Segment;
+    ByteArrayView           _Input;
     int                     _Index;
     int                     _NumWakeupChars;
-#endif
 };
 
 #endif // __Slip_Encoder_H__
@@ -0,0 +1,56 @@
+/**
+ * @file    UartRx.cpp
+ *
+ * @brief   Implementation of class UartRx
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include <stdio.h>
+#include "UartRx.h"
+
+
+/**
+ * @brief   class constructor
+ *
+ * @param   client  receiver of data chunks
+ */
+UartRx::UartRx( UartRx::Client* client )
+      : _Client ( client )
+      , _Stats  () {
+}
+
+
+/**
+ * @brief   hand a chunk to the client and count it
+ *
+ * @param   data    received bytes
+ * @param   n       number of bytes
+ */
+void
+UartRx::deliver( const uint8_t* data, uint32_t n ) {
+    if ( 0 == n ) {
+        return;
+    }
+    _Stats.Bytes += n;
+    _Stats.Chunks++;
+    if ( _Client ) {
+        _Client->OnUartRx_Data( data, n );
+    }
+}
+
+
+/**
+ * @brief   prints receive statistics
+ */
+void
+UartRx::print( void ) const {
+    printf( "UART RX %s: bytes %lu, chunks %lu, overruns %lu, high water %lu\r\n", Name(),
+        (unsigned long)_Stats.Bytes, (unsigned long)_Stats.Chunks,
+        (unsigned long)_Stats.Overruns, (unsigned long)_Stats.HighWater );
+}
@@ -0,0 +1,120 @@
+/**
+ * @file    UartRx.h
+ *
+ * @brief   Declaration of class UartRx
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _UartRx_H_
+#define _UartRx_H_
+
+#include <stdint.h>
+
+
+/**
+ * @brief   The UartRx class is the interface of UART receive engines.
+ *          An engine buffers incoming bytes in the background (ISR ring, DMA, pty)
+ *          and hands them to its client in chunks.
+ *
+ *          - UartRx_Serial   HardwareSerial, ISR-filled ring of the core
+ *          - UartRx_DMA      STM32 HAL circular DMA with idle-line detection
+ *          - UartRx_Pty      host pseudo-terminal, for testing
+ */
+
+class UartRx {
+
+public:
+
+    /**
+     * @brief The Client class
+     */
+
+    class Client {
+
+    public:
+        //<! handler for received bytes
+        virtual void OnUartRx_Data( const uint8_t* /* data */, uint32_t /* n */ ) { }
+    };
+
+    //<! receive statistics
+    struct Stats {
+        uint32_t    Bytes;          //!< bytes delivered
+        uint32_t    Chunks;         //!< chunks delivered
+        uint32_t    Overruns;       //!< buffer overruns, bytes were lost
+        uint32_t    HighWater;      //!< max bytes pending in the buffer
+    };
+
+    /**
+     * @brief   class constructor
+     *
+     * @param   client  receiver of data chunks
+     */
+                    UartRx( UartRx::Client* client = nullptr );
+
+    virtual        ~UartRx( void ) { }
+
+    /**
+     * @brief   start reception
+     *
+     * @return  true/false
+     */
+    virtual bool    Start( void ) = 0;
+
+    /**
+     * @brief   stop reception
+     */
+    virtual void    Stop( void ) = 0;
+
+    /**
+     * @brief   hand pending bytes to the client
+     *
+     * @return  number of delivered bytes
+     */
+    virtual uint32_t    Poll( void ) = 0;
+
+    /**
+     * @return  engine name
+     */
+    virtual const char* Name( void ) const = 0;
+
+    /**
+     * @brief   set receiver of data chunks
+     */
+    void            SetClient( UartRx::Client* client ) { _Client = client; }
+
+    /**
+     * @return  receive statistics
+     */
+    const Stats&    GetStats( void ) const { return _Stats; }
+
+    /**
+     * @brief   prints receive statistics
+     */
+    void            print( void ) const;
+
+protected:
+
+    /**
+     * @brief   hand a chunk to the client and count it
+     */
+    void            deliver( const uint8_t* data, uint32_t n );
+
+    /**
+     * @brief   update high water mark of pending bytes
+     */
+    void            pending( uint32_t n ) { if ( n > _Stats.HighWater ) _Stats.HighWater = n; }
+
+    //<! receiver of data chunks
+    UartRx::Client*     _Client;
+
+    //<! receive statistics
+    Stats               _Stats;
+};
+
+#endif // _UartRx_H_
@@ -0,0 +1,159 @@
+/**
+ * @file    UartRx_DMA.cpp
+ *
+ * @brief   Implementation of class UartRx_DMA
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include "UartRx_DMA.h"
+
+#if 0 != _UARTRX_DMA_
+
+//<! init static members
+UartRx_DMA* UartRx_DMA::_Instances[ UartRx_DMA::Max_Instances ] = { nullptr };
+
+
+/**
+ * @brief   HAL RX event: half/full buffer or idle line
+ */
+extern "C" void
+HAL_UARTEx_RxEventCallback( UART_HandleTypeDef* huart, uint16_t Size ) {
+    UartRx_DMA::OnRxEvent( huart, Size );
+}
+
+
+/**
+ * @brief   class constructor
+ *
+ * @param   huart           initialised UART handle with circular RX DMA
+ * @param   client          receiver of data chunks
+ * @param   deliverInIsr    deliver chunks from the RX event interrupt
+ */
+UartRx_DMA::UartRx_DMA( UART_HandleTypeDef* huart, UartRx::Client* client, bool deliverInIsr )
+          : UartRx          ( client )
+          , _Handle         ( huart )
+          , _DeliverInIsr   ( deliverInIsr )
+          , _Position       ( 0 )
+          , _Written        ( 0 )
+          , _Read           ( 0 ) {
+}
+
+
+/**
+ * @brief   start circular DMA reception with idle-line detection
+ *
+ * @return  true/false
+ */
+bool
+UartRx_DMA::Start( void ) {
+    uint8_t i = 0;
+    while ( ( i < Max_Instances ) && ( nullptr != _Instances[i] ) && ( this != _Instances[i] ) ) {
+        i++;
+    }
+    if ( Max_Instances == i ) {
+        return false;
+    }
+    _Instances[i] = this;
+
+    _Position = 0;
+    _Written  = 0;
+    _Read     = 0;
+    return ( HAL_OK == HAL_UARTEx_ReceiveToIdle_DMA( _Handle, _Buffer, Buffer_Size ) );
+}
+
+
+/**
+ * @brief   stop reception
+ */
+void
+UartRx_DMA::Stop( void ) {
+    HAL_UART_DMAStop( _Handle );
+    for ( uint8_t i = 0; i < Max_Instances; i++ ) {
+        if ( this == _Instances[i] ) {
+            _Instances[i] = nullptr;
+        }
+    }
+}
+
+
+/**
+ * @brief   hand pending bytes to the client
+ *
+ * @return  number of delivered bytes
+ */
+uint32_t
+UartRx_DMA::Poll( void ) {
+    // a UART error (e.g. overrun) aborts the DMA reception, restart it
+    if ( HAL_UART_STATE_READY == _Handle->RxState ) {
+        _Stats.Overruns++;
+        _Position = 0;
+        _Written  = 0;
+        _Read     = 0;
+        HAL_UARTEx_ReceiveToIdle_DMA( _Handle, _Buffer, Buffer_Size );
+        return 0;
+    }
+    return _DeliverInIsr ? 0 : drain();
+}
+
+
+/**
+ * @brief   RX event from HAL_UARTEx_RxEventCallback
+ *
+ * @param   huart       UART handle
+ * @param   position    DMA position in buffer, Buffer_Size at wrap
+ */
+void
+UartRx_DMA::OnRxEvent( UART_HandleTypeDef* huart, uint16_t position ) {
+    for ( uint8_t i = 0; i < Max_Instances; i++ ) {
+        UartRx_DMA* rx = _Instances[i];
+        if ( rx && ( huart == rx->_Handle ) ) {
+            uint16_t last = rx->_Position;
+            rx->_Written += ( position >= last ) ? ( position - last ) : ( Buffer_Size - last + position );
+            rx->_Position = ( Buffer_Size == position ) ? 0 : position;
+            if ( rx->_DeliverInIsr ) {
+                rx->drain();
+            }
+            return;
+        }
+    }
+}
+
+
+/**
+ * @brief   deliver bytes between read and DMA position, in two pieces at wrap
+ *
+ * @return  number of delivered bytes
+ */
+uint32_t
+UartRx_DMA::drain( void ) {
+    uint32_t written = _Written;
+    uint32_t count   = written - _Read;
+    if ( 0 == count ) {
+        return 0;
+    }
+    pending( count );
+    if ( count > Buffer_Size ) {
+        // DMA lapped the reader, the buffer content is not consistent any more
+        _Stats.Overruns++;
+        _Read = written;
+        return 0;
+    }
+
+    uint16_t index = (uint16_t)( _Read % Buffer_Size );
+    uint32_t first = Buffer_Size - index;
+    if ( first > count ) {
+        first = count;
+    }
+    deliver( _Buffer + index, first );
+    deliver( _Buffer, count - first );
+    _Read = written;
+    return count;
+}
+
+#endif // _UARTRX_DMA_
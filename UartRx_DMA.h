@@ -0,0 +1,108 @@
+/**
+ * @file    UartRx_DMA.h
+ *
+ * @brief   Declaration of class UartRx_DMA
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _UartRx_DMA_H_
+#define _UartRx_DMA_H_
+
+#include "UartRx.h"
+
+#if defined( ARDUINO_ARCH_STM32 )
+#include <Arduino.h>
+#endif
+
+#if defined( ARDUINO_ARCH_STM32 ) && defined( HAL_UART_MODULE_ENABLED ) && defined( HAL_DMA_MODULE_ENABLED )
+//<! STM32 HAL circular DMA receive engine available
+#define _UARTRX_DMA_    1
+#else
+#define _UARTRX_DMA_    0
+#endif
+
+#if 0 != _UARTRX_DMA_
+
+/**
+ * @brief   The UartRx_DMA class receives into a circular DMA buffer with
+ *          idle-line detection (HAL_UARTEx_ReceiveToIdle_DMA). The DMA position
+ *          is taken in HAL_UARTEx_RxEventCallback at half, full and idle line,
+ *          so a chunk is ready as soon as the line goes idle.
+ *
+ * @note    the UART handle must be initialised with a DMA channel linked in
+ *          circular mode and IRQ handlers calling HAL_UART_IRQHandler() and
+ *          HAL_DMA_IRQHandler(); the UART must not be opened by HardwareSerial
+ */
+
+class UartRx_DMA : public UartRx {
+
+public:
+
+    enum {
+        //<! DMA buffer size, bytes not polled within one buffer time are lost
+        Buffer_Size     =   512,
+        //<! max engines for HAL callback routing
+        Max_Instances   =   2
+    };
+
+    /**
+     * @brief   class constructor
+     *
+     * @param   huart           initialised UART handle with circular RX DMA
+     * @param   client          receiver of data chunks
+     * @param   deliverInIsr    true  - chunks are delivered from the RX event interrupt
+     *                          false - chunks are delivered by Poll()
+     */
+                    UartRx_DMA( UART_HandleTypeDef* huart, UartRx::Client* client = nullptr, bool deliverInIsr = false );
+
+    bool            Start( void ) override;
+    void            Stop( void ) override;
+    uint32_t        Poll( void ) override;
+    const char*     Name( void ) const override { return "dma"; }
+
+    /**
+     * @brief   RX event from HAL_UARTEx_RxEventCallback
+     *
+     * @param   huart       UART handle
+     * @param   position    DMA position in buffer
+     */
+    static void     OnRxEvent( UART_HandleTypeDef* huart, uint16_t position );
+
+private:
+
+    /**
+     * @brief   deliver bytes between read and DMA position
+     */
+    uint32_t        drain( void );
+
+    //<! UART handle
+    UART_HandleTypeDef*     _Handle;
+
+    //<! deliver from interrupt instead of Poll()
+    bool                    _DeliverInIsr;
+
+    //<! circular DMA buffer
+    uint8_t                 _Buffer[ Buffer_Size ];
+
+    //<! last DMA position, written in ISR
+    volatile uint16_t       _Position;
+
+    //<! bytes written by DMA since Start(), written in ISR
+    volatile uint32_t       _Written;
+
+    //<! bytes delivered since Start()
+    uint32_t                _Read;
+
+    //<! engines for HAL callback routing
+    static UartRx_DMA*      _Instances[ Max_Instances ];
+};
+
+#endif // _UARTRX_DMA_
+
+#endif // _UartRx_DMA_H_
@@ -0,0 +1,116 @@
+/**
+ * @file    UartRx_Pty.cpp
+ *
+ * @brief   Implementation of class UartRx_Pty
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include "UartRx_Pty.h"
+
+#if 0 != _UARTRX_PTY_
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+
+/**
+ * @brief   class constructor
+ *
+ * @param   client  receiver of data chunks
+ */
+UartRx_Pty::UartRx_Pty( UartRx::Client* client )
+          : UartRx  ( client )
+          , _Fd     ( -1 ) {
+    _SlaveName[0] = 0;
+}
+
+
+/**
+ * @brief   class destructor
+ */
+UartRx_Pty::~UartRx_Pty( void ) {
+    Stop();
+}
+
+
+/**
+ * @brief   open a pseudo-terminal in raw, non-blocking mode
+ *
+ * @return  true/false
+ */
+bool
+UartRx_Pty::Start( void ) {
+    if ( 0 <= _Fd ) {
+        return true;
+    }
+    _Fd = posix_openpt( O_RDWR | O_NOCTTY );
+    if ( 0 > _Fd ) {
+        return false;
+    }
+    if ( ( 0 != grantpt( _Fd ) ) || ( 0 != unlockpt( _Fd ) )
+      || ( 0 != ptsname_r( _Fd, _SlaveName, sizeof( _SlaveName ) ) ) ) {
+        Stop();
+        return false;
+    }
+
+    // raw bytes, no echo, no line discipline
+    struct termios tio;
+    if ( 0 == tcgetattr( _Fd, &tio ) ) {
+        cfmakeraw( &tio );
+        tcsetattr( _Fd, TCSANOW, &tio );
+    }
+    fcntl( _Fd, F_SETFL, fcntl( _Fd, F_GETFL ) | O_NONBLOCK );
+    return true;
+}
+
+
+/**
+ * @brief   close the pseudo-terminal
+ */
+void
+UartRx_Pty::Stop( void ) {
+    if ( 0 <= _Fd ) {
+        close( _Fd );
+    }
+    _Fd = -1;
+    _SlaveName[0] = 0;
+}
+
+
+/**
+ * @brief   hand pending bytes to the client
+ *
+ * @return  number of delivered bytes
+ */
+uint32_t
+UartRx_Pty::Poll( void ) {
+    if ( 0 > _Fd ) {
+        return 0;
+    }
+
+    int available = 0;
+    if ( ( 0 == ioctl( _Fd, FIONREAD, &available ) ) && ( 0 < available ) ) {
+        pending( (uint32_t)available );
+    }
+
+    uint8_t     chunk[ Chunk_Size ];
+    uint32_t    delivered = 0;
+    ssize_t     n;
+    while ( 0 < ( n = read( _Fd, chunk, sizeof( chunk ) ) ) ) {
+        deliver( chunk, (uint32_t)n );
+        delivered += (uint32_t)n;
+    }
+    return delivered;
+}
+
+#endif // _UARTRX_PTY_
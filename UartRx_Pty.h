@@ -0,0 +1,78 @@
+/**
+ * @file    UartRx_Pty.h
+ *
+ * @brief   Declaration of class UartRx_Pty
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _UartRx_Pty_H_
+#define _UartRx_Pty_H_
+
+#include "UartRx.h"
+
+#if !defined( ARDUINO ) && defined( __unix__ )
+//<! host pseudo-terminal receive engine available
+#define _UARTRX_PTY_    1
+#else
+#define _UARTRX_PTY_    0
+#endif
+
+#if 0 != _UARTRX_PTY_
+
+/**
+ * @brief   The UartRx_Pty class receives from the master side of a host
+ *          pseudo-terminal. A test tool or a real serial port bridge (socat)
+ *          writes the radio byte stream to the slave side, GetSlaveName().
+ */
+
+class UartRx_Pty : public UartRx {
+
+public:
+
+    enum {
+        //<! bytes handed to the client per chunk
+        Chunk_Size      =   256
+    };
+
+    /**
+     * @brief   class constructor
+     *
+     * @param   client  receiver of data chunks
+     */
+                    UartRx_Pty( UartRx::Client* client = nullptr );
+
+                   ~UartRx_Pty( void );
+
+    bool            Start( void ) override;
+    void            Stop( void ) override;
+    uint32_t        Poll( void ) override;
+    const char*     Name( void ) const override { return "pty"; }
+
+    /**
+     * @return  path of the slave side, empty if not started
+     */
+    const char*     GetSlaveName( void ) const { return _SlaveName; }
+
+    /**
+     * @return  file descriptor of the master side, -1 if not started
+     */
+    int             GetFd( void ) const { return _Fd; }
+
+private:
+
+    //<! master side
+    int             _Fd;
+
+    //<! path of the slave side
+    char            _SlaveName[64];
+};
+
+#endif // _UARTRX_PTY_
+
+#endif // _UartRx_Pty_H_
@@ -0,0 +1,83 @@
+/**
+ * @file    UartRx_Serial.cpp
+ *
+ * @brief   Implementation of class UartRx_Serial
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include "UartRx_Serial.h"
+
+
+/**
+ * @brief   class constructor
+ *
+ * @param   port    serial port, opened by its owner
+ * @param   client  receiver of data chunks
+ */
+UartRx_Serial::UartRx_Serial( HardwareSerial& port, UartRx::Client* client )
+             : UartRx   ( client )
+             , _Port    ( port ) {
+}
+
+
+/**
+ * @brief   start reception, the ISR ring runs as soon as the port is open
+ *
+ * @return  true
+ */
+bool
+UartRx_Serial::Start( void ) {
+    return true;
+}
+
+
+/**
+ * @brief   stop reception, nothing to do, the port belongs to its owner
+ */
+void
+UartRx_Serial::Stop( void ) {
+}
+
+
+/**
+ * @brief   drain the ISR ring in chunks
+ *
+ * @return  number of delivered bytes
+ */
+uint32_t
+UartRx_Serial::Poll( void ) {
+
+    uint8_t     chunk[ Chunk_Size ];
+    uint32_t    delivered = 0;
+    int         available = _Port.available();
+
+    if ( 0 >= available ) {
+        return 0;
+    }
+    pending( (uint32_t)available );
+#ifdef SERIAL_RX_BUFFER_SIZE
+    // a full ring has most likely dropped bytes
+    if ( available >= ( SERIAL_RX_BUFFER_SIZE - 1 ) ) {
+        _Stats.Overruns++;
+    }
+#endif
+
+    // only what is there now, so a busy line can not hold the caller forever
+    while ( 0 < available ) {
+        // never ask for more than available, readBytes() would wait for its timeout
+        size_t n = _Port.readBytes( chunk, ( available < (int)sizeof( chunk ) ) ? (size_t)available : sizeof( chunk ) );
+        if ( 0 == n ) {
+            break;
+        }
+        deliver( chunk, (uint32_t)n );
+        delivered += (uint32_t)n;
+        available -= (int)n;
+    }
+    return delivered;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file    UartRx_Serial.h
+ *
+ * @brief   Declaration of class UartRx_Serial
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _UartRx_Serial_H_
+#define _UartRx_Serial_H_
+
+#include "UartRx.h"
+#include "HardwareSerial.h"
+
+
+/**
+ * @brief   The UartRx_Serial class receives through HardwareSerial. Bytes are
+ *          buffered by the ring which the core fills from the UART ISR, its size
+ *          is set with -DSERIAL_RX_BUFFER_SIZE in build_opt.h. Poll() drains the
+ *          ring in chunks.
+ */
+
+class UartRx_Serial : public UartRx {
+
+public:
+
+    enum {
+        //<! bytes handed to the client per chunk
+        Chunk_Size      =   64
+    };
+
+    /**
+     * @brief   class constructor
+     *
+     * @param   port    serial port, opened by its owner
+     * @param   client  receiver of data chunks
+     */
+                    UartRx_Serial( HardwareSerial& port, UartRx::Client* client = nullptr );
+
+    bool            Start( void ) override;
+    void            Stop( void ) override;
+    uint32_t        Poll( void ) override;
+    const char*     Name( void ) const override { return "serial"; }
+
+private:
+
+    //<! serial port
+    HardwareSerial&     _Port;
+};
+
+#endif // _UartRx_Serial_H_
@@ -0,0 +1,415 @@
+/**
+ * @file    UartTx.cpp
+ *
+ * @brief   Implementation of class UartTx
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#include <stdio.h>
+#include "UartTx.h"
+#include "CRC16.h"
+#include "CurrentTime.h"           //getTimeInMs()
+
+
+//<! free slots a class must leave for higher classes
+static const uint8_t    ReservedSlots[ UartTx::Num_Classes ] = { 0, 1, 2 };
+
+//<! max queue wait of a class before it overtakes higher classes, 0 = never ages
+static const uint32_t   AgingLimit_ms[ UartTx::Num_Classes ] = { 0, UartTx::Aging_Normal_ms, UartTx::Aging_Bulk_ms };
+
+//<! class names for print()
+static const char*      ClassNames[ UartTx::Num_Classes ] = { "control", "normal", "bulk" };
+
+
+/**
+ * @brief   class constructor
+ *
+ * @param   port    serial port, opened by its owner
+ */
+UartTx::UartTx( HardwareSerial& port )
+      : _Port       ( port )
+      , _Encoder    ()
+      , _NumFree    ( Tx_Slots )
+      , _Queues     ()
+      , _Current    ( No_Slot )
+      , _Polling    ( false )
+      , _Awake      ( false )
+      , _BatchWindow_ms ( 0 )
+      , _Stats      ()
+      , _ClassStats () {
+    for ( uint8_t i = 0; i < Tx_Slots; i++ ) {
+        _Free[i] = i;
+    }
+}
+
+
+/**
+ * @brief   queue a message for transmission, the first bytes are written at once
+ *
+ * @param   frame           message incl. CRC, it is copied
+ * @param   numWakeupChars  wakeup chars sent ahead of the frame
+ * @param   client          receiver of the completion, optional
+ * @param   priority        priority class
+ *
+ * @return  true if queued
+ */
+bool
+UartTx::Send( const ByteArrayView& frame, uint16_t numWakeupChars, UartTx::Client* client, SerialMessage::Priority priority ) {
+
+    TxSlot* slot = claim( frame, numWakeupChars, client, priority );
+    if ( nullptr == slot ) {
+        return false;
+    }
+    slot->Payload   = ByteArrayView();
+    slot->Scattered = false;
+
+    publish( slot );
+    return true;
+}
+
+
+/**
+ * @brief   queue a message made of header and caller-owned payload
+ *
+ * @param   header          message header without CRC, it is copied, its priority class is used
+ * @param   payload         payload, must stay valid until completion
+ * @param   numWakeupChars  wakeup chars sent ahead of the frame
+ * @param   client          receiver of the completion, optional
+ *
+ * @return  true if queued
+ */
+bool
+UartTx::Send( const SerialMessage& header, const ByteArrayView& payload, uint16_t numWakeupChars, UartTx::Client* client ) {
+
+    TxSlot* slot = claim( header, numWakeupChars, client, header.GetPriority() );
+    if ( nullptr == slot ) {
+        return false;
+    }
+
+    //running CRC across header and payload, one's complement LSB first
+    CRC16       crc16;
+    const ByteArray& data = header;
+    crc16.Calc( data );
+    uint16_t crc = crc16.Calc_X25( payload );
+
+    slot->CRC[0]    = (uint8_t)( crc );
+    slot->CRC[1]    = (uint8_t)( crc >> 8 );
+    slot->Payload   = payload;
+    slot->Scattered = true;
+
+    publish( slot );
+    return true;
+}
+
+
+/**
+ * @brief   claim a free slot for the class and copy the message into it
+ *
+ * @param   frame           message, it is copied
+ * @param   numWakeupChars  wakeup chars sent ahead of the frame
+ * @param   client          receiver of the completion
+ * @param   priority        priority class
+ *
+ * @return  slot, nullptr if no slot left for the class or message too long
+ */
+UartTx::TxSlot*
+UartTx::claim( const ByteArrayView& frame, uint16_t numWakeupChars, UartTx::Client* client, SerialMessage::Priority priority ) {
+
+    if ( SerialMessage::Num_Priorities <= priority ) {
+        priority = SerialMessage::Priority_Normal;
+    }
+
+    // lower classes leave slots for higher ones
+    if ( _NumFree <= ReservedSlots[ priority ] ) {
+        _Stats.Rejected++;
+        _ClassStats[ priority ].Rejected++;
+        return nullptr;
+    }
+
+    TxSlot& slot = _Slots[ _Free[ _NumFree - 1 ] ];
+    slot.Message.clear();
+    slot.Message.append( frame );
+    if ( slot.Message.count() != frame.count() ) {
+        //does not fit a slot
+        _Stats.Rejected++;
+        _ClassStats[ priority ].Rejected++;
+        return nullptr;
+    }
+    _NumFree--;
+    slot.Priority    = priority;
+    slot.WakeupChars = numWakeupChars;
+    slot.Client      = client;
+    return &slot;
+}
+
+
+/**
+ * @brief   queue the claimed slot, the first bytes are written at once
+ *
+ * @param   slot    claimed slot
+ */
+void
+UartTx::publish( TxSlot* slot ) {
+
+    ClassQueue& queue = _Queues[ slot->Priority ];
+    queue.Slots[ ( queue.First + queue.Count ) % Tx_Slots ] = (uint8_t)( slot - _Slots );
+    queue.Count++;
+    slot->Queued = getTimeInMs();
+
+    if ( queue.Count > _ClassStats[ slot->Priority ].HighWater ) {
+        _ClassStats[ slot->Priority ].HighWater = queue.Count;
+    }
+    uint8_t depth = GetDepth();
+    if ( depth > _Stats.HighWater ) {
+        _Stats.HighWater = depth;
+    }
+
+    if ( !_Polling ) {
+        Poll();
+    }
+}
+
+
+/**
+ * @brief   take the next message: the class waiting longest beyond its aging
+ *          limit, else the highest class
+ *
+ * @return  slot index, No_Slot if none is queued
+ */
+uint8_t
+UartTx::next( void ) {
+
+    uint32_t    time    = getTimeInMs();
+    int         pick    = -1;
+    int         aged    = -1;
+    uint32_t    overdue = 0;
+
+    for ( uint8_t cls = 0; cls < Num_Classes; cls++ ) {
+        const ClassQueue& queue = _Queues[ cls ];
+        if ( 0 == queue.Count ) {
+            continue;
+        }
+        if ( 0 > pick ) {
+            pick = cls;
+        }
+        // lower class overdue longest is served first
+        uint32_t wait = time - _Slots[ queue.Slots[ queue.First ] ].Queued;
+        if ( ( cls != pick ) && ( 0 < AgingLimit_ms[ cls ] ) && ( wait >= AgingLimit_ms[ cls ] )
+          && ( ( 0 > aged ) || ( wait - AgingLimit_ms[ cls ] > overdue ) ) ) {
+            aged    = cls;
+            overdue = wait - AgingLimit_ms[ cls ];
+        }
+    }
+    if ( 0 > pick ) {
+        return No_Slot;
+    }
+    if ( 0 <= aged ) {
+        pick = aged;
+    }
+
+    ClassQueue& queue = _Queues[ pick ];
+    uint8_t     index = queue.Slots[ queue.First ];
+    queue.First = ( queue.First + 1 ) % Tx_Slots;
+    queue.Count--;
+
+    ClassStats& stats = _ClassStats[ pick ];
+    uint32_t    wait  = time - _Slots[ index ].Queued;
+    stats.Wait_ms += wait;
+    if ( wait > stats.MaxWait_ms ) {
+        stats.MaxWait_ms = wait;
+    }
+    if ( aged == pick ) {
+        stats.Aged++;
+    }
+    return index;
+}
+
+
+/**
+ * @brief   check if messages are held for the wakeup batch: the oldest message
+ *          needs a wakeup and is younger than the window, no control message
+ *          is waiting and slots are left
+ *
+ * @return  true if sending waits for the batch window
+ */
+bool
+UartTx::hold( void ) const {
+
+    if ( _Awake || ( 0 == _BatchWindow_ms ) || ( 0 < _Queues[ SerialMessage::Priority_Control ].Count )
+      || ( _NumFree <= ReservedSlots[ SerialMessage::Priority_Bulk ] ) ) {
+        return false;
+    }
+
+    uint32_t    time   = getTimeInMs();
+    uint32_t    oldest = 0;
+    bool        wakeup = false;
+    for ( uint8_t cls = 0; cls < Num_Classes; cls++ ) {
+        const ClassQueue& queue = _Queues[ cls ];
+        if ( 0 == queue.Count ) {
+            continue;
+        }
+        const TxSlot& slot = _Slots[ queue.Slots[ queue.First ] ];
+        if ( time - slot.Queued >= oldest ) {
+            oldest = time - slot.Queued;
+            wakeup = ( 0 < slot.WakeupChars );
+        }
+    }
+    return wakeup && ( oldest < _BatchWindow_ms );
+}
+
+
+/**
+ * @brief   write encoded bytes while the port has room, complete sent messages
+ *
+ * @return  number of bytes written
+ */
+uint32_t
+UartTx::Poll( void ) {
+
+    uint8_t     chunk[ Chunk_Size ];
+    uint32_t    written = 0;
+
+    _Polling = true;
+    for ( ;; ) {
+
+        // the next message is chosen when the port takes it, not before
+        int room = _Port.availableForWrite();
+        if ( 0 >= room ) {
+            break;
+        }
+
+        if ( No_Slot == _Current ) {
+            if ( hold() ) {
+                break;
+            }
+            _Current = next();
+            if ( No_Slot == _Current ) {
+                // burst ends, the module may sleep
+                _Awake = false;
+                break;
+            }
+            TxSlot& slot = _Slots[ _Current ];
+
+            // back to back behind a preamble, the module is still awake
+            uint16_t wakeupChars = slot.WakeupChars;
+            if ( 0 < wakeupChars ) {
+                if ( _Awake ) {
+                    _Stats.Batched++;
+                    wakeupChars = 0;
+                } else {
+                    _Stats.Wakeups++;
+                    _Awake = ( 0 < _BatchWindow_ms );
+                }
+            }
+
+            if ( slot.Scattered ) {
+                const ByteArrayView segments[] = {
+                    slot.Message,
+                    slot.Payload,
+                    ByteArrayView( slot.CRC, sizeof( slot.CRC ) )
+                };
+                _Encoder.SetInput( segments, 3, wakeupChars );
+            } else {
+                _Encoder.SetInput( slot.Message, wakeupChars );
+            }
+        }
+
+        uint16_t size = ( room < (int)sizeof( chunk ) ) ? (uint16_t)room : (uint16_t)sizeof( chunk );
+        uint16_t n    = _Encoder.GetEncodedBytes( chunk, size );
+        if ( 0 < n ) {
+            _Port.write( chunk, (size_t)n );
+            _Stats.Bytes += n;
+            written += n;
+        }
+
+        // short chunk, last byte of the frame is in the TX ring
+        if ( n < size ) {
+            _Encoder.OnCompleteIndication();
+            complete( true );
+        }
+    }
+    _Polling = false;
+    return written;
+}
+
+
+/**
+ * @brief   discard queued messages, clients see sent = false, messages
+ *          queued from their callbacks stay queued
+ */
+void
+UartTx::Reset( void ) {
+    _Encoder.Reset();
+    _Awake   = false;
+    _Polling = true;
+
+    // take the queued slots first, a client queueing again from its
+    // callback keeps its new message
+    uint8_t     discard[ Tx_Slots ];
+    uint8_t     count = 0;
+    if ( No_Slot != _Current ) {
+        discard[ count++ ] = _Current;
+    }
+    for ( uint8_t cls = 0; cls < Num_Classes; cls++ ) {
+        ClassQueue& queue = _Queues[ cls ];
+        while ( 0 < queue.Count ) {
+            discard[ count++ ] = queue.Slots[ queue.First ];
+            queue.First = ( queue.First + 1 ) % Tx_Slots;
+            queue.Count--;
+        }
+    }
+
+    for ( uint8_t i = 0; i < count; i++ ) {
+        _Current = discard[ i ];
+        complete( false );
+    }
+    _Polling = false;
+}
+
+
+/**
+ * @brief   release the slot being sent and tell its client
+ *
+ * @param   sent    false if discarded
+ */
+void
+UartTx::complete( bool sent ) {
+    uint8_t index = _Current;
+    TxSlot& slot  = _Slots[ index ];
+    if ( sent ) {
+        _Stats.Frames++;
+        _ClassStats[ slot.Priority ].Frames++;
+    }
+    _Current = No_Slot;
+    // the client sees its message before the slot is released, a Send from
+    // the callback claims another slot
+    if ( slot.Client ) {
+        slot.Client->OnUartTx_Complete( slot.Message, sent );
+    }
+    _Free[ _NumFree++ ] = index;
+}
+
+
+/**
+ * @brief   prints transmit statistics
+ */
+void
+UartTx::print( void ) const {
+    printf( "UART TX: %u/%u queued, high water %u, frames %lu, bytes %lu, rejected %lu, wakeups %lu, batched %lu\r\n",
+        GetDepth(), Tx_Slots, _Stats.HighWater,
+        (unsigned long)_Stats.Frames, (unsigned long)_Stats.Bytes, (unsigned long)_Stats.Rejected,
+        (unsigned long)_Stats.Wakeups, (unsigned long)_Stats.Batched );
+    for ( uint8_t cls = 0; cls < Num_Classes; cls++ ) {
+        const ClassStats& stats = _ClassStats[ cls ];
+        printf( "  %-7s: %u queued, high water %u, frames %lu, rejected %lu, aged %lu, wait avg %lu ms, max %lu ms\r\n",
+            ClassNames[ cls ], _Queues[ cls ].Count, stats.HighWater,
+            (unsigned long)stats.Frames, (unsigned long)stats.Rejected, (unsigned long)stats.Aged,
+            (unsigned long)( stats.Frames ? stats.Wait_ms / stats.Frames : 0 ), (unsigned long)stats.MaxWait_ms );
+    }
+}
@@ -0,0 +1,271 @@
+/**
+ * @file    UartTx.h
+ *
+ * @brief   Declaration of class UartTx
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _UartTx_H_
+#define _UartTx_H_
+
+#include "SerialMessage.h"
+#include "SlipEncoder.h"
+#include "HardwareSerial.h"
+
+
+/**
+ * @brief   The UartTx class is a non-blocking transmit engine for HCI messages.
+ *          Send() queues a copy of the message and returns at once, Poll() feeds
+ *          the bufferless SlipEncoder into the interrupt driven TX ring of
+ *          HardwareSerial as far as there is room. Nothing waits for the UART.
+ *
+ *          Messages are queued per priority class (SerialMessage::Priority),
+ *          the next message is taken by strict priority unless a lower class
+ *          waited longer than its aging limit, so bulk data can not starve.
+ *          The slots are shared, lower classes leave some free for higher ones.
+ *
+ *          Wakeup batching, for power saving modules: messages with wakeup chars
+ *          are held up to the batch window, then go out back to back after a
+ *          single wakeup preamble. Poll() must be called while messages are held.
+ *
+ * @note    the TX shift register empty interrupt belongs to the core, so a
+ *          message is complete when its last byte is in the TX ring
+ */
+
+class UartTx {
+
+public:
+
+    enum {
+        //<! message slots shared by all classes
+        Tx_Slots        =   6,
+        //<! encoded bytes handed to the port per write
+        Chunk_Size      =   32,
+        //<! priority classes
+        Num_Classes     =   SerialMessage::Num_Priorities,
+        //<! max wait of a normal message before it overtakes control messages
+        Aging_Normal_ms =   50,
+        //<! max wait of a bulk message before it overtakes higher classes
+        Aging_Bulk_ms   =   200
+    };
+
+    /**
+     * @brief The Client class
+     */
+
+    class Client {
+
+    public:
+        //<! handler for a message leaving the queue, sent = false if discarded by Reset()
+        virtual void OnUartTx_Complete( const SerialMessage& /* msg */, bool /* sent */ ) { }
+    };
+
+    //<! transmit statistics
+    struct Stats {
+        uint32_t    Frames;         //!< messages sent
+        uint32_t    Bytes;          //!< SLIP encoded bytes written
+        uint32_t    Rejected;       //!< messages not queued, queue full
+        uint8_t     HighWater;      //!< max messages queued
+        uint32_t    Wakeups;        //!< wakeup preambles sent
+        uint32_t    Batched;        //!< messages sent without their preamble, module awake
+    };
+
+    //<! statistics of a priority class
+    struct ClassStats {
+        uint32_t    Frames;         //!< messages sent
+        uint32_t    Rejected;       //!< messages not queued, no slot for the class
+        uint32_t    Aged;           //!< messages sent ahead of higher classes by aging
+        uint32_t    Wait_ms;        //!< sum of queue wait times, Wait_ms / Frames is the mean
+        uint32_t    MaxWait_ms;     //!< max queue wait time
+        uint8_t     HighWater;      //!< max messages queued
+    };
+
+    /**
+     * @brief   class constructor
+     *
+     * @param   port    serial port, opened by its owner
+     */
+                    UartTx( HardwareSerial& port );
+
+    /**
+     * @brief   queue a message for transmission
+     *
+     * @param   frame           message incl. CRC, it is copied
+     * @param   numWakeupChars  wakeup chars sent ahead of the frame
+     * @param   client          receiver of the completion, optional
+     * @param   priority        priority class
+     *
+     * @return  true if queued
+     */
+    bool            Send( const ByteArrayView& frame, uint16_t numWakeupChars = 0, UartTx::Client* client = nullptr,
+                          SerialMessage::Priority priority = SerialMessage::Priority_Normal );
+
+    /**
+     * @brief   queue a message made of header and caller-owned payload, the CRC
+     *          is calculated across both, the payload is only copied onto the wire
+     *
+     * @param   header          message header without CRC, it is copied, its priority class is used
+     * @param   payload         payload, must stay valid until completion
+     * @param   numWakeupChars  wakeup chars sent ahead of the frame
+     * @param   client          receiver of the completion, optional
+     *
+     * @return  true if queued
+     */
+    bool            Send( const SerialMessage& header, const ByteArrayView& payload,
+                          uint16_t numWakeupChars = 0, UartTx::Client* client = nullptr );
+
+    /**
+     * @brief   write encoded bytes while the port has room, complete sent messages
+     *
+     * @return  number of bytes written
+     */
+    uint32_t        Poll( void );
+
+    /**
+     * @brief   discard queued messages, clients see sent = false, messages
+     *          queued from their callbacks stay queued
+     */
+    void            Reset( void );
+
+    /**
+     * @brief   set the wakeup batching window
+     *
+     * @param   window_ms   max latency added to a message with wakeup chars, 0 = off
+     */
+    void            SetWakeupBatching( uint16_t window_ms ) { _BatchWindow_ms = window_ms; }
+
+    /**
+     * @return  wakeup batching window in ms, 0 = off
+     */
+    uint16_t        GetWakeupBatching( void ) const { return _BatchWindow_ms; }
+
+    /**
+     * @return  true if no message is queued
+     */
+    bool            IsIdle( void ) const { return ( Tx_Slots == _NumFree ); }
+
+    /**
+     * @return  number of queued messages, incl. the one being sent
+     */
+    uint8_t         GetDepth( void ) const { return Tx_Slots - _NumFree; }
+
+    /**
+     * @return  number of messages of a class waiting, excl. the one being sent
+     */
+    uint8_t         GetDepth( SerialMessage::Priority priority ) const { return _Queues[ priority ].Count; }
+
+    /**
+     * @return  transmit statistics
+     */
+    const Stats&    GetStats( void ) const { return _Stats; }
+
+    /**
+     * @return  statistics of a priority class
+     */
+    const ClassStats& GetClassStats( SerialMessage::Priority priority ) const { return _ClassStats[ priority ]; }
+
+    /**
+     * @brief   prints transmit statistics
+     */
+    void            print( void ) const;
+
+private:
+
+    //<! no slot
+    static constexpr uint8_t    No_Slot = 0xFF;
+
+    //<! queued message
+    struct TxSlot {
+        FixedSerialMessage<>    Message;        //!< HCI message incl. CRC, or header only
+        ByteArrayView           Payload;        //!< caller-owned payload of a header only message
+        uint8_t                 CRC[ SerialMessage::CRC_Size ];     //!< CRC of a header only message
+        bool                    Scattered;      //!< Message is a header, frame is Message + Payload + CRC
+        SerialMessage::Priority Priority;       //!< priority class
+        uint16_t                WakeupChars;    //!< wakeup chars ahead of the frame
+        uint32_t                Queued;         //!< ms time stamp of Send()
+        UartTx::Client*         Client;         //!< receiver of the completion
+    };
+
+    //<! FIFO of slot indices of a priority class
+    struct ClassQueue {
+        uint8_t                 Slots[ Tx_Slots ];
+        uint8_t                 First;
+        uint8_t                 Count;
+    };
+
+    /**
+     * @brief   claim a free slot for the class and copy the message into it
+     *
+     * @return  slot, nullptr if no slot left for the class or message too long
+     */
+    TxSlot*         claim( const ByteArrayView& frame, uint16_t numWakeupChars, UartTx::Client* client,
+                           SerialMessage::Priority priority );
+
+    /**
+     * @brief   queue the claimed slot and start sending
+     */
+    void            publish( TxSlot* slot );
+
+    /**
+     * @brief   take the next message, by priority or aging
+     *
+     * @return  slot index, No_Slot if none is queued
+     */
+    uint8_t         next( void );
+
+    /**
+     * @brief   check if messages are held for the wakeup batch
+     *
+     * @return  true if sending waits for the batch window
+     */
+    bool            hold( void ) const;
+
+    /**
+     * @brief   release the slot being sent and tell its client
+     */
+    void            complete( bool sent );
+
+    //<! serial port
+    HardwareSerial&     _Port;
+
+    //<! encodes the message at _Tail while it is written
+    SlipEncoder         _Encoder;
+
+    //<! message slots
+    TxSlot              _Slots[ Tx_Slots ];
+
+    //<! stack of free slot indices
+    uint8_t             _Free[ Tx_Slots ];
+
+    //<! number of free slots
+    uint8_t             _NumFree;
+
+    //<! queued messages per class
+    ClassQueue          _Queues[ Num_Classes ];
+
+    //<! slot being sent, No_Slot if none
+    uint8_t             _Current;
+
+    //<! inside Poll(), a Send() from a completion must not re-enter it
+    bool                _Polling;
+
+    //<! module woken by a preamble and kept awake by back to back messages
+    bool                _Awake;
+
+    //<! wakeup batching window in ms, 0 = off
+    uint16_t            _BatchWindow_ms;
+
+    //<! transmit statistics
+    Stats               _Stats;
+
+    //<! statistics per class
+    ClassStats          _ClassStats[ Num_Classes ];
+};
+
+#endif // _UartTx_H_
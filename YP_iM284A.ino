@@ -296,8 +296,12 @@ void CommandHandler( void ) {
 }
 
 void RadioHandler( void ) {
-  if ( pDemoApp->GetSerial().available() )
-    pDemoApp->OnSerialPort_ReadyRead();
+  //receive engine buffers in the background, hand its chunks to the SLIP decoder
+  pDemoApp->OnSerialPort_ReadyRead();
+  //transmit engine refills the TX ring, SendMessage() never waits for it
+  pDemoApp->OnSerialPort_BytesWritten();
+  //one queued frame per pass, so reading is never stalled for long
+  pDemoApp->DispatchMessages();
 }
 
 #define MonitorDelayTicks 1
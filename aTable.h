@@ -0,0 +1,226 @@
+/**
+ * @file    aTable.h
+ *
+ * @brief   Declaration of classes aDenseMap and aSortedMap
+ *
+ * @note    This example code is free software: you can redistribute it and/or modify it.
+ *
+ *          This program is provided by EDI on an "AS IS" basis without
+ *          any warranties in the hope that it will be useful.
+ *
+ * Gatis Gaigals @ EDI, 2024
+ */
+
+#ifndef _aTable_H_
+#define _aTable_H_
+
+#include <cstdint>
+#include <cstddef>
+
+
+/**
+ * @brief   constant key-value tables with the read API of aMap
+ *          (value( key, default ), contains( key )) plus reverse key( value ) lookup.
+ *
+ *          The tables are built by the compiler, a constexpr or const object
+ *          is placed in flash (.rodata): no heap, no static-init code.
+ *
+ *          - aDenseMap     direct indexed array, dense uint8_t keys 0..N-1
+ *          - aSortedMap    sorted array, binary search, sparse keys
+ *
+ *          constexpr aDenseMap< const char*, 3 > names = {{
+ *              { 0, "zero" },
+ *              { 2, "two" }
+ *          }};
+ */
+
+//<! table entry, also the initializer of a table
+template < typename Key, typename T >
+
+struct aEntry {
+    Key     key;
+    T       value;
+};
+
+
+//<! default of value() if none is given, "" for strings like aMap
+template < typename T >
+
+struct aTableDefault {
+    static constexpr T  value() { return T(); }
+};
+
+template <>
+
+struct aTableDefault < const char* > {
+    static constexpr const char*    value() { return ""; }
+};
+
+
+//<! value compare of reverse lookup, strings by content
+template < typename T >
+
+constexpr bool
+aTableSame( const T& a, const T& b ) {
+    return a == b;
+}
+
+constexpr bool
+aTableSame( const char* a, const char* b ) {
+    if ( ( nullptr == a ) || ( nullptr == b ) ) {
+        return a == b;
+    }
+    while ( *a && ( *a == *b ) ) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+
+/**
+ * @brief   The aDenseMap class is a direct indexed table for dense uint8_t keys
+ *          0..N-1, value lookup is a single array access.
+ *
+ * @note    a key >= N in the initializer does not compile
+ */
+
+template < typename T, uint16_t N >
+
+class aDenseMap {
+
+    static_assert( ( 0 < N ) && ( N <= 256 ), "aDenseMap: 1..256 uint8_t keys" );
+
+private:
+    //<! values by key
+    T           _values[ N ];
+
+    //<! keys present
+    bool        _valid[ N ];
+
+    //<! number of keys present
+    uint16_t    _count;
+
+public:
+    //constructor, builds the table at compile time
+    template < size_t M >
+    constexpr aDenseMap( const aEntry< uint8_t, T > ( &entries )[ M ] ) :
+        _values(), _valid(), _count( 0 ) {
+        for ( size_t i = 0; i < M; i++ ) {
+            if ( !_valid[ entries[i].key ] ) {
+                _count++;
+            }
+            _values[ entries[i].key ] = entries[i].value;
+            _valid[ entries[i].key ]  = true;
+        }
+    }
+
+    //check if the table contains a key
+    constexpr bool contains( uint8_t key ) const {
+        return ( key < N ) && _valid[ key ];
+    }
+
+    //get the value associated with a key, or return a default value if the key is not found
+    constexpr T value( uint8_t key, const T& defaultValue = aTableDefault< T >::value() ) const {
+        return contains( key ) ? _values[ key ] : defaultValue;
+    }
+
+    //get the first key associated with a value, or return a default key if the value is not found
+    constexpr uint8_t key( const T& value, uint8_t defaultKey = 0 ) const {
+        for ( uint16_t i = 0; i < N; i++ ) {
+            if ( _valid[i] && aTableSame( _values[i], value ) ) {
+                return (uint8_t)i;
+            }
+        }
+        return defaultKey;
+    }
+
+    //number of keys
+    constexpr uint16_t size() const {
+        return _count;
+    }
+};
+
+
+/**
+ * @brief   The aSortedMap class is a table of N entries sorted by key,
+ *          value lookup is a binary search.
+ *
+ * @note    the initializer may be in any order, it is sorted at compile time
+ */
+
+template < typename Key, typename T, uint16_t N >
+
+class aSortedMap {
+
+private:
+    //<! entries sorted by key
+    aEntry< Key, T >    _entries[ N ];
+
+    //<! index of key, N if not found
+    constexpr uint16_t find( const Key& key ) const {
+        uint16_t first = 0;
+        uint16_t last  = N;
+        while ( first < last ) {
+            uint16_t middle = first + ( ( last - first ) >> 1 );
+            if ( _entries[ middle ].key < key ) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        return ( ( first < N ) && !( key < _entries[ first ].key ) ) ? first : N;
+    }
+
+public:
+    //constructor, builds the table at compile time
+    constexpr aSortedMap( const aEntry< Key, T > ( &entries )[ N ] ) :
+        _entries() {
+        //insertion sort, N is small
+        for ( uint16_t i = 0; i < N; i++ ) {
+            uint16_t j = i;
+            while ( ( 0 < j ) && ( entries[i].key < _entries[ j - 1 ].key ) ) {
+                _entries[j] = _entries[ j - 1 ];
+                j--;
+            }
+            _entries[j] = entries[i];
+        }
+    }
+
+    //check if the table contains a key
+    constexpr bool contains( const Key& key ) const {
+        return N != find( key );
+    }
+
+    //get the value associated with a key, or return a default value if the key is not found
+    constexpr T value( const Key& key, const T& defaultValue = aTableDefault< T >::value() ) const {
+        uint16_t index = find( key );
+        return ( N != index ) ? _entries[ index ].value : defaultValue;
+    }
+
+    //get the first key associated with a value, or return a default key if the value is not found
+    constexpr Key key( const T& value, const Key& defaultKey = Key() ) const {
+        for ( uint16_t i = 0; i < N; i++ ) {
+            if ( aTableSame( _entries[i].value, value ) ) {
+                return _entries[i].key;
+            }
+        }
+        return defaultKey;
+    }
+
+    //number of entries
+    constexpr uint16_t size() const {
+        return N;
+    }
+
+    //entries in key order
+    constexpr const aEntry< Key, T >* begin() const {
+        return _entries;
+    }
+
+    constexpr const aEntry< Key, T >* end() const {
+        return _entries + N;
+    }
+};
+
+#endif // _aTable_H_
@@ -1 +1 @@
--DENABLE_HWSERIAL1 -DENABLE_HWSERIAL2 -DENABLE_HWSERIAL4 -DENABLE_HWSERIAL5
+-DENABLE_HWSERIAL1 -DENABLE_HWSERIAL2 -DENABLE_HWSERIAL4 -DENABLE_HWSERIAL5 -DSERIAL_RX_BUFFER_SIZE=256
@@ -18,6 +18,8 @@
 #include "iM284A_L0.h"
 
 #include "LoRa_Mesh_DemoApp.h"
+#include "BufferPool.h"
+#include "Benchmark.h"
 extern LoRaMesh_DemoApp* pDemoApp;
 
 
@@ -47,6 +49,12 @@ const char cDescription0k[] = "send Packet to Node(B)";
 const char cDescription0C[] = "Misc";
 const char cDescription0p[] = "print demo setup";
 const char cDescription0t[] = "test radio serial monitor";
+const char cDescription0m[] = "print buffer pool statistics";
+const char cDescription0x[] = "benchmark hex conversion";
+const char cDescription0y[] = "benchmark CRC16 engines";
+const char cDescription0z[] = "benchmark SLIP encoder";
+const char cDescription0r[] = "print RX queue statistics";
+const char cDescription0w[] = "print TX queue statistics";
 
 const Command_t Commands_L0[] = {
   { ' ', cDescription00, &printUsage },
@@ -74,7 +82,13 @@ const Command_t Commands_L0[] = {
   { 'k', cDescription0k, &SendPacketToNode_B },
   { '-', cDescription0C, nullptr },
   { 'p', cDescription0p, &printDemo },
-  { 't', cDescription0t, &testRadioSerialMonitor }
+  { 't', cDescription0t, &testRadioSerialMonitor },
+  { 'm', cDescription0m, &printPoolStats },
+  { 'r', cDescription0r, &printRxStats },
+  { 'w', cDescription0w, &printTxStats },
+  { 'x', cDescription0x, &benchmarkHex },
+  { 'y', cDescription0y, &benchmarkCRC16 },
+  { 'z', cDescription0z, &benchmarkSlipEncode }
 };
 
 const uint8_t cntCommands_L0 = sizeof( Commands_L0 ) / sizeof( Commands_L0[0] );
@@ -228,3 +242,27 @@ void testRadioSerialMonitor( void ) {
     printf("testRadioSerialMonitor");
     pDemoApp->TestRadioSerialMonitor();
 }
+
+void printPoolStats( void ) {
+    BufferPool::print();
+}
+
+void printRxStats( void ) {
+    pDemoApp->printRxStats();
+}
+
+void printTxStats( void ) {
+    pDemoApp->printTxStats();
+}
+
+void benchmarkHex( void ) {
+    Benchmark::HexConversion();
+}
+
+void benchmarkCRC16( void ) {
+    Benchmark::CRC16Engines();
+}
+
+void benchmarkSlipEncode( void ) {
+    Benchmark::SlipEncode();
+}
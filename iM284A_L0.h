@@ -44,5 +44,11 @@ void GetRoutingInfo( void );
 void SendPacketToNode_A( void );
 void SendPacketToNode_B( void );
 void testRadioSerialMonitor( void );
+void printPoolStats( void );
+void printRxStats( void );
+void printTxStats( void );
+void benchmarkHex( void );
+void benchmarkCRC16( void );
+void benchmarkSlipEncode( void );
 
 #endif // _iM284A_L0_h_